@@ -0,0 +1,59 @@
+#ifndef __Asynchronous_Limits_hpp_
+#define __Asynchronous_Limits_hpp_
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "obscura/DM_Distribution.hpp"
+#include "obscura/DM_Particle.hpp"
+#include "obscura/Direct_Detection.hpp"
+
+namespace obscura
+{
+
+// Upper limit curve computed in the background, which the calling thread can follow or abort.
+// Works on copies of the detector (including its checkpoint), DM particle, and distribution.
+// After each mass, the callback receives the mass, its limit, and the completed and total masses.
+// After a cancellation or the time budget (s), no new masses are started.
+class Asynchronous_Limit_Curve
+{
+  private:
+	struct State;
+	std::shared_ptr<State> state;
+	std::thread thread;
+
+  public:
+	Asynchronous_Limit_Curve(const DM_Detector& detector, const DM_Particle& DM, const DM_Distribution& DM_distr, const std::vector<double>& masses, double certainty = 0.95, unsigned int threads = 1, std::function<void(double, double, unsigned int, unsigned int)> callback = nullptr, double time_budget = 0.0);
+	// For several certainty levels, the callback receives one limit per level.
+	Asynchronous_Limit_Curve(const DM_Detector& detector, const DM_Particle& DM, const DM_Distribution& DM_distr, const std::vector<double>& masses, const std::vector<double>& certainties, unsigned int threads = 1, std::function<void(double, const std::vector<double>&, unsigned int, unsigned int)> callback = nullptr, double time_budget = 0.0);
+	Asynchronous_Limit_Curve(Asynchronous_Limit_Curve&& other) = default;
+	Asynchronous_Limit_Curve(const Asynchronous_Limit_Curve&) = delete;
+	Asynchronous_Limit_Curve& operator=(const Asynchronous_Limit_Curve&) = delete;
+	// The destructor cancels the computation and waits for the ongoing masses.
+	~Asynchronous_Limit_Curve();
+
+	void Cancel();
+	bool Cancelled() const;
+	bool Time_Budget_Exceeded() const;
+	bool Finished() const;
+
+	void Wait();
+	// Returns true if the computation finished within the given time in seconds.
+	bool Wait_For(double seconds);
+
+	unsigned int Number_of_Masses() const;
+	unsigned int Completed_Masses() const;
+
+	// The limit curves of the masses completed so far, for the first or all certainty levels
+	std::vector<std::vector<double>> Partial_Limit_Curve() const;
+	std::vector<std::vector<std::vector<double>>> Partial_Limit_Curves() const;
+	// Waits for the computation to finish and returns the (possibly partial) limit curves.
+	std::vector<std::vector<double>> Get();
+	std::vector<std::vector<std::vector<double>>> Get_Limit_Curves();
+};
+
+}	// namespace obscura
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <libconfig.h++>
 #include <string>
+#include <vector>
 
 #include "obscura/DM_Distribution.hpp"
 #include "obscura/DM_Particle.hpp"
@@ -18,6 +19,8 @@ class Configuration
 	std::string cfg_file;
 
 	void Read_Config_File();
+	// Hash of all settings except the number of threads, which identifies the checkpoints
+	void Compute_Configuration_Hash();
 
 	void Initialize_Result_Folder(int MPI_rank = 0);
 	void Create_Result_Folder(int MPI_rank = 0);
@@ -42,12 +45,27 @@ class Configuration
   public:
 	std::string ID;
 	std::string results_path;
+	std::string configuration_hash;
 
 	//Direct detection constraints
 	double constraints_mass_min, constraints_mass_max;
 	unsigned int constraints_masses;
 
 	double constraints_certainty;
+	// All certainty levels, if a list is given, with constraints_certainty as the first one
+	std::vector<double> constraints_certainties;
+	// Unique labels of the certainty levels in percent, e.g. "95" or "99.73"
+	std::vector<std::string> constraints_certainty_labels;
+
+	unsigned int constraints_threads = 1;
+
+	// Adaptive mass grid, where constraints_masses sets the number of initial mass points.
+	bool constraints_adaptive			 = false;
+	double constraints_tolerance		 = 0.02;
+	unsigned int constraints_refinements = 6;
+
+	// Finished masses are appended to a checkpoint in the results folder.
+	bool constraints_checkpoint = true;
 
 	DM_Particle* DM			  = {nullptr};
 	DM_Distribution* DM_distr = {nullptr};
@@ -26,6 +26,10 @@ class DM_Distribution
 	// Constructors:
 	DM_Distribution();
 	DM_Distribution(std::string label, double rhoDM, double vMin, double vMax);
+	virtual ~DM_Distribution() {};
+
+	// Copy for worker threads, which derived classes have to implement
+	virtual DM_Distribution* Clone() const;
 
 	double Minimum_DM_Speed() const;
 	double Maximum_DM_Speed() const;
@@ -67,6 +71,8 @@ class Imported_DM_Distribution : public DM_Distribution
 	Imported_DM_Distribution(double rho, const std::string& filepath);
 	Imported_DM_Distribution(std::vector<std::vector<double>>& pdf_table, double rho = 1.0);
 
+	virtual Imported_DM_Distribution* Clone() const override { return new Imported_DM_Distribution(*this); };
+
 	virtual double PDF_Speed(double v) override;
 
 	virtual double Eta_Function(double vMin) override;
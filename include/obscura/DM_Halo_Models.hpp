@@ -30,6 +30,8 @@ class Standard_Halo_Model : public DM_Distribution
 	Standard_Halo_Model(double rho, double v0, double vobs, double vesc = 1.0);
 	Standard_Halo_Model(double rho, double v0, libphysica::Vector& vel_obs, double vesc = 1.0);
 
+	virtual Standard_Halo_Model* Clone() const override { return new Standard_Halo_Model(*this); };
+
 	//Set SHM parameters
 	virtual void Set_Speed_Dispersion(double v0);
 	void Set_Escape_Velocity(double vesc);
@@ -79,6 +81,8 @@ class SHM_Plus_Plus : public Standard_Halo_Model
 	SHM_Plus_Plus(double rho, double v0, double vobs, double vesc, double e = 0.2, double b = 0.9);
 	SHM_Plus_Plus(double rho, double v0, libphysica::Vector& vel_obs, double vesc, double e = 0.2, double b = 0.9);
 
+	virtual SHM_Plus_Plus* Clone() const override { return new SHM_Plus_Plus(*this); };
+
 	//Set SHM++ parameters
 	virtual void Set_Speed_Dispersion(double v0) override;
 
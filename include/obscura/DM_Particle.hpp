@@ -39,6 +39,10 @@ class DM_Particle
 	//Constructors:
 	DM_Particle();
 	explicit DM_Particle(double m, double s = 1.0 / 2.0);
+	virtual ~DM_Particle() {};
+
+	// Copy for worker threads, which derived classes have to implement
+	virtual DM_Particle* Clone() const;
 
 	virtual void Set_Mass(double mDM);
 	void Set_Spin(double s);
@@ -34,6 +34,8 @@ class DM_Particle_Standard : public DM_Particle
 	DM_Particle_Standard();
 	DM_Particle_Standard(double mDM, double pre);
 
+	virtual DM_Particle_Standard* Clone() const override { return new DM_Particle_Standard(*this); };
+
 	virtual void Set_Mass(double mDM) override;
 
 	// Primary interaction parameter, in this case the proton, neutron, or electron cross section
@@ -80,6 +82,8 @@ class DM_Particle_SI : public DM_Particle_Standard
 	explicit DM_Particle_SI(double mDM);
 	DM_Particle_SI(double mDM, double sigmaP);
 
+	virtual DM_Particle_SI* Clone() const override { return new DM_Particle_SI(*this); };
+
 	void Set_FormFactor_DM(std::string ff, double mMed = -1.0);
 	void Set_Mediator_Mass(double m);
 
@@ -118,6 +122,8 @@ class DM_Particle_SD : public DM_Particle_Standard
 	explicit DM_Particle_SD(double mDM);
 	DM_Particle_SD(double mDM, double sigmaP);
 
+	virtual DM_Particle_SD* Clone() const override { return new DM_Particle_SD(*this); };
+
 	// Differential cross sections with nuclear isotopes, elements, and electrons
 	virtual double dSigma_dq2_Nucleus(double q, const Isotope& target, double vDM, double param = -1.0) const override;
 	virtual double dSigma_dq2_Electron(double q, double vDM, double param = -1.0) const override;
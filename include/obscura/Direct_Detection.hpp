@@ -1,15 +1,54 @@
 #ifndef __Direct_Detection_hpp_
 #define __Direct_Detection_hpp_
 
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "libphysica/Numerics.hpp"
+
 #include "obscura/DM_Distribution.hpp"
 #include "obscura/DM_Particle.hpp"
 
 namespace obscura
 {
 
+// Likelihood ratio contour in the plane of DM masses and couplings, given by points {mass, coupling}.
+struct Likelihood_Contour
+{
+	double certainty_level;
+	double delta_chi_square;
+	bool closed;
+	std::vector<std::vector<double>> points;
+};
+
+// Spectrum dN/dE of a detector (including the exposure), tabulated with its cumulative integral.
+// The spectrum vanishes outside the tabulated energies.
+class Tabulated_Spectrum
+{
+  private:
+	std::vector<double> energies, cumulative_signals;
+	libphysica::Interpolation interpolation;
+	double kinematic_endpoint;
+
+  public:
+	Tabulated_Spectrum();
+	Tabulated_Spectrum(const std::vector<double>& energy_grid, const std::vector<double>& spectrum, double endpoint = 0.0);
+
+	double operator()(double E) const;
+	// Expected signals between the lowest tabulated energy and E, and between E_1 and E_2.
+	double Cumulative_Signals(double E) const;
+	double Signals(double E_1, double E_2) const;
+	double Total_Signals() const;
+	// Energy below which the given number of signals is expected.
+	double Inverse_Cumulative_Signals(double signals) const;
+
+	std::vector<double> Energies() const;
+	// Highest energy deposit allowed by kinematics, or 0 if unknown.
+	double Kinematic_Endpoint() const;
+};
+
 // DM Detector base class, which provides the statistical methods and energy bins.
 class DM_Detector
 {
@@ -24,6 +63,32 @@ class DM_Detector
 	void Initialize_Poisson();
 	unsigned long int observed_events;
 	double expected_background;
+	// The observed events of (binned) Poisson statistics, with one entry per bin.
+	std::vector<double> Observed_Events() const;
+
+	// Feldman-Cousins intervals for (binned) Poisson statistics
+	bool using_feldman_cousins = false;
+
+	// Bayesian upper limits of (binned) Poisson statistics
+	bool using_bayesian_limits					  = false;
+	std::string bayesian_prior					  = "Flat";
+	double bayesian_minimum_interaction_parameter = 0.0;
+	double Fiducial_Upper_Limit_Bayesian(const DM_Particle& DM, const std::vector<double>& events, double certainty) const;
+
+	// Background normalization as profiled nuisance parameter
+	bool profiling_background					= false;
+	bool profiling_background_per_bin			= true;
+	double background_normalization_uncertainty	= 0.0;
+	// The events need not be integers, e.g. for the Asimov data set.
+	std::vector<double> Background_Normalizations(const std::vector<double>& signals, const std::vector<double>& events, const std::vector<double>& backgrounds) const;
+	double Log_Background_Constraint(const std::vector<double>& normalizations) const;
+
+	// Asymptotic likelihood ratio test of the signal strength r [Cowan2011]
+	bool using_likelihood_ratio = false;
+	double Log_Likelihood_Poisson_Signal_Strength(double r, const std::vector<double>& signals, const std::vector<double>& events) const;
+	double Best_Fit_Poisson_Signal_Strength(const std::vector<double>& signals, const std::vector<double>& events) const;
+	double P_Value_Likelihood_Ratio(DM_Particle& DM, DM_Distribution& DM_distr);
+	double Fiducial_Upper_Limit_Likelihood_Ratio(const DM_Particle& DM, const std::vector<double>& events, double certainty) const;
 
 	// (b) Binned Poisson statistics
 	void Initialize_Binned_Poisson(unsigned bins);
@@ -32,20 +97,101 @@ class DM_Detector
 	std::vector<unsigned long int> bin_observed_events;
 	std::vector<double> bin_expected_background;
 
-	// Fiducial values used for finding upper limits with (binned) Poisson statistics
-	// To find a limit, the (binned) expecation values are only computed once per mass, and then re-scaled.
-	bool using_fiducial_values = false;
-	double fiducial_coupling   = 0.0;
-	double fiducial_signals	   = 0.0;
+	// Fiducial values for upper limits and likelihood scans, computed once per mass and re-scaled
+	bool using_fiducial_values		   = false;
+	double fiducial_coupling		   = 0.0;
+	double fiducial_kinematic_endpoint = 0.0;
+	double fiducial_signals			   = 0.0;
 	std::vector<double> fiducial_spectrum;
+	std::vector<double> fiducial_gaps;
+	Tabulated_Spectrum fiducial_energy_spectrum;
+	double Fiducial_Rescaling_Factor(const DM_Particle& DM) const;
+	std::vector<double> Log_Likelihoods_Fixed_Mass(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& couplings);
+	// Also stores the maximum log likelihood within [coupling_min, coupling_max].
+	std::vector<double> Log_Likelihoods_Fixed_Mass(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& couplings, double coupling_min, double coupling_max, double& log_likelihood_max);
+
+	// Coupling of the fiducial signals re-scaled by the given factor, or -1 outside the search range.
+	double Rescaled_Fiducial_Coupling(const DM_Particle& DM, double rescaling_factor) const;
+	// Limit from the inverse Poisson CDF or the Feldman-Cousins belt, without root finding.
+	double Fiducial_Upper_Limit_Poisson(const DM_Particle& DM, const std::vector<double>& events, double certainty) const;
+	// Limit with a profiled background
+	double Fiducial_Upper_Limit_Profiled_Poisson(const DM_Particle& DM, const std::vector<double>& events, double certainty) const;
+	// Limit of (binned) Poisson statistics without CLs. The events need not be integers.
+	double Fiducial_Upper_Limit_Rescaled(const DM_Particle& DM, const std::vector<double>& events, double certainty) const;
+	// Limit of Yellin's methods for the given fiducial gaps.
+	double Fiducial_Upper_Limit_Gaps(const DM_Particle& DM, const std::vector<double>& gaps, double certainty) const;
+	// Otherwise, the root finding starts around a positive guess.
+	double Fiducial_Upper_Limit(DM_Particle& DM, DM_Distribution& DM_distr, double certainty, double limit_guess);
+	// Limits for several certainty levels, which share the fiducial values.
+	std::vector<double> Upper_Limits_Fixed_Mass(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& certainties, const std::vector<double>& limit_guesses);
+	// Checkpoint of finished limits, identified by the configuration and certainty levels
+	std::string checkpoint_file = "";
+	std::string checkpoint_hash = "";
+	std::string Checkpoint_Header(const std::vector<double>& certainties) const;
+	// A new checkpoint is only started if the existing header differs.
+	void Create_Checkpoint(const std::vector<double>& certainties);
+	std::vector<std::vector<double>> Import_Checkpoint(const std::vector<double>& certainties) const;
+	void Append_To_Checkpoint(double mass, const std::vector<double>& limits) const;
+	// One refinement of an adaptive limit curve. Returns false if no interval is bisected.
+	bool Refine_Limit_Curve(DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double>& masses, std::vector<std::vector<double>>& limits, const std::vector<double>& certainties, double tolerance, unsigned int threads);
+	// Asimov limits at a fixed mass for all combinations of exposures and backgrounds
+	std::vector<double> Projected_Limits(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& exposures, const std::vector<double>& backgrounds, double certainty);
 
 	// (c) Maximum gap a'la Yellin
 	std::vector<double> maximum_gap_energy_data;
+	std::vector<double> Maximum_Gap_Signals(const Tabulated_Spectrum& spectrum) const;
+	std::vector<double> Gap_Signals(DM_Particle& DM, DM_Distribution& DM_distr);
 	double P_Value_Maximum_Gap(DM_Particle& DM, DM_Distribution& DM_distr);
 
+	// (d) Optimum interval a'la Yellin, based on the same energy data as the maximum gap method
+	double P_Value_Optimum_Interval(DM_Particle& DM, DM_Distribution& DM_distr);
+
+	// (e) Unbinned extended likelihood, based on the same energy data, with a flat background
+	// Returns the total signals and stores the spectrum at the events in event_spectrum.
+	double Unbinned_Signals(const Tabulated_Spectrum& spectrum, std::vector<double>& event_spectrum) const;
+	// The energy data without the bounds of the energy range
+	std::vector<double> Unbinned_Events() const;
+	std::vector<double> Unbinned_Event_Spectrum(const Tabulated_Spectrum& spectrum, const std::vector<double>& events) const;
+	double Unbinned_Background_Spectrum() const;
+	// ln L = -(r * S + B) + sum_i ln(r * s_i + b) for the signals rescaled by r.
+	double Log_Likelihood_Unbinned(const std::vector<double>& event_spectrum, double signals, double rescaling_factor) const;
+	// P value and upper limit from the asymptotic likelihood ratio
+	double P_Value_Unbinned(DM_Particle& DM, DM_Distribution& DM_distr);
+	double Fiducial_Upper_Limit_Unbinned(const DM_Particle& DM, const std::vector<double>& event_spectrum, double certainty) const;
+
+	// CLs P values from pseudo-experiments [Read2002]
+	bool using_CLs						= false;
+	double CLs_precision				= 0.005;
+	unsigned long int CLs_maximum_toys	= 100000;
+	unsigned long int CLs_seed			= 42;
+	unsigned int CLs_threads			= 0;
+	double P_Value_CLs(DM_Particle& DM, DM_Distribution& DM_distr);
+
+	// Name of the statistical method used for (binned) Poisson statistics
+	std::string Poisson_Statistics() const;
+	// The methods exclude each other, except for the likelihood ratio with profiling.
+	void Check_Statistical_Methods(const std::string& function) const;
+
 	// Energy spectrum
 	double energy_threshold, energy_max;
 
+	// Reduces the number of spectrum points in the coarse pass of progressive limit curves
+	unsigned int spectrum_coarsening = 1;
+	unsigned int Spectrum_Points(unsigned int points) const;
+
+	// Copies of the DM particle, distribution, and detector for each worker thread
+	// With a single worker and full spectra, the originals are used.
+	struct Worker_Copies
+	{
+		std::vector<DM_Particle*> particles;
+		std::vector<DM_Distribution*> distributions;
+		std::vector<DM_Detector*> detectors;
+		std::vector<std::unique_ptr<DM_Particle>> particle_copies;
+		std::vector<std::unique_ptr<DM_Distribution>> distribution_copies;
+		std::vector<std::unique_ptr<DM_Detector>> detector_copies;
+	};
+	Worker_Copies Copies_For_Workers(DM_Particle& DM, DM_Distribution& DM_distr, unsigned int workers, unsigned int coarsening = 1);
+
 	// (a) Poisson: Energy threshold
 	bool using_energy_threshold;
 
@@ -62,8 +208,15 @@ class DM_Detector
 	: targets("base targets"), exposure(0.0), flat_efficiency(1.0), statistical_analysis("Poisson"), observed_events(0), expected_background(0.0), number_of_bins(0), energy_threshold(0), energy_max(0), using_energy_threshold(false), using_energy_bins(false), name("base name") {};
 	DM_Detector(std::string label, double expo, std::string target_type)
 	: targets(target_type), exposure(expo), flat_efficiency(1.0), statistical_analysis("Poisson"), observed_events(0), expected_background(0.0), number_of_bins(0), energy_threshold(0), energy_max(0), using_energy_threshold(false), using_energy_bins(false), name(label) {};
+	virtual ~DM_Detector() {};
 
-	std::string Target_Particles();
+	// Polymorphic copy, which derived classes must override
+	virtual DM_Detector* Clone() const;
+	// Copy for a worker thread, whose CLs pseudo-experiments run on that thread only
+	DM_Detector* Worker_Clone() const;
+
+	std::string Target_Particles() const;
+	std::string Statistical_Analysis() const;
 
 	void Set_Flat_Efficiency(double eff);
 
@@ -72,6 +225,10 @@ class DM_Detector
 	virtual double Minimum_DM_Speed(DM_Particle& DM) const { return 0.0; };
 	virtual double Minimum_DM_Mass(DM_Particle& DM, const DM_Distribution& DM_distr) const { return 0.0; };
 	virtual double dRdE(double E, const DM_Particle& DM, DM_Distribution& DM_distr) { return 0.0; };
+	// Spectrum at a list of energies, which derived classes can set up once for all energies
+	virtual std::vector<double> dRdE_Batch(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr);
+	// Spectrum tabulated between the threshold and the maximum energy (or the kinematic endpoint)
+	Tabulated_Spectrum DM_Spectrum(const DM_Particle& DM, DM_Distribution& DM_distr);
 	virtual double DM_Signals_Total(const DM_Particle& DM, DM_Distribution& DM_distr);
 	double DM_Signal_Rate_Total(const DM_Particle& DM, DM_Distribution& DM_distr);
 	virtual std::vector<double> DM_Signals_Binned(const DM_Particle& DM, DM_Distribution& DM_distr);
@@ -79,21 +236,53 @@ class DM_Detector
 	// Statistics
 	double Log_Likelihood(DM_Particle& DM, DM_Distribution& DM_distr);
 	double Likelihood(DM_Particle& DM, DM_Distribution& DM_distr);
-	std::vector<std::vector<double>> Log_Likelihood_Scan(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& masses, const std::vector<double>& couplings);
+	// The masses can be distributed over multiple threads (0 uses all hardware threads).
+	std::vector<std::vector<double>> Log_Likelihood_Scan(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& masses, const std::vector<double>& couplings, unsigned int threads = 1);
+	// Contours of 2 * (ln L_max - ln L) for the given certainty levels (chi-squared with 2 dof)
+	// Traced with marching squares on a log grid, where only cells next to a contour are refined.
+	std::vector<Likelihood_Contour> Likelihood_Contours(DM_Particle& DM, DM_Distribution& DM_distr, double mass_min, double mass_max, double coupling_min, double coupling_max, const std::vector<double>& certainty_levels = {0.68, 0.95}, unsigned int initial_masses = 10, unsigned int initial_couplings = 10, unsigned int refinements = 4, unsigned int threads = 1);
 	double P_Value(DM_Particle& DM, DM_Distribution& DM_distr);
+	// Likelihoods and P values re-scale the signals of the current mass until the values are reset.
+	void Set_Fiducial_Values(DM_Particle& DM, DM_Distribution& DM_distr);
+	void Reset_Fiducial_Values();
 
 	// (a) Poisson
 	void Set_Observed_Events(unsigned long int N);
 	void Set_Expected_Background(double B);
 
+	// P values and upper limits from Feldman-Cousins confidence belts
+	// The following methods exclude each other, except for the likelihood ratio with profiling.
+	void Use_Feldman_Cousins(bool use_feldman_cousins = true);
+
+	// Bayesian credible limits with a "Flat" or "Log" prior of the interaction parameter
+	// The log prior requires a positive lower bound of the interaction parameter.
+	void Use_Bayesian_Limits(bool use_bayesian_limits = true, std::string prior = "Flat", double minimum_interaction_parameter = 0.0);
+
+	// Profiled background normalization (per bin or global) with a Gaussian constraint
+	void Use_Background_Profiling(bool use_background_profiling, double relative_uncertainty, bool per_bin = true);
+
+	// P values and upper limits from CLs = p_(s+b) / (1 - p_b) with pseudo-experiments
+	// Toys are generated until the uncertainty of CLs is below the precision (0 threads uses all).
+	void Use_CLs(bool use_CLs = true, double precision = 0.005, unsigned long int maximum_toys = 100000, unsigned long int seed = 42, unsigned int threads = 0);
+
+	// P values and upper limits from the asymptotic one-sided likelihood ratio of the signal strength
+	void Use_Likelihood_Ratio(bool use_likelihood_ratio = true);
+
 	// (b) Binned Poisson
 	void Set_Observed_Events(std::vector<unsigned long int> Ni);
 	void Set_Bin_Efficiencies(const std::vector<double>& eff);
 	void Set_Expected_Background(const std::vector<double>& Bi);
 
 	// (c) Maximum gap
+	// The energies {E_thr, E_1, ..., E_N, E_max} describe N events within the energy range.
 	void Use_Maximum_Gap(std::vector<double> energies);
 
+	// (d) Optimum interval
+	void Use_Optimum_Interval(std::vector<double> energies);
+
+	// (e) Unbinned likelihood, with the energies in the same convention as Yellin's methods
+	void Use_Unbinned_Likelihood(std::vector<double> energies);
+
 	// Energy spectrum
 	//  (a) Poisson
 	void Use_Energy_Threshold(double Ethr, double Emax);
@@ -102,7 +291,38 @@ class DM_Detector
 
 	// Limits/Constraints
 	double Upper_Limit(DM_Particle& DM, DM_Distribution& DM_distr, double certainty = 0.95);
-	std::vector<std::vector<double>> Upper_Limit_Curve(DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double> masses, double certainty = 0.95);
+	// The root finding can start from a guess, e.g. the limit at a nearby mass.
+	double Upper_Limit(DM_Particle& DM, DM_Distribution& DM_distr, double certainty, double limit_guess);
+	// Every 4th mass of a limit curve is computed first, and the others start from its limit.
+	static unsigned int Warm_Start_Mass_Index(unsigned int i);
+	// One limit (or -1) or limit curve per certainty level
+	std::vector<double> Upper_Limit(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& certainties);
+	// Limit curves append every finished mass to the checkpoint file, such that runs can be resumed.
+	void Use_Checkpoint(const std::string& filename, const std::string& configuration_hash = "");
+	// The mass points can be distributed over multiple threads (0 uses all hardware threads).
+	std::vector<std::vector<double>> Upper_Limit_Curve(DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double> masses, double certainty = 0.95, unsigned int threads = 1);
+	std::vector<std::vector<std::vector<double>>> Upper_Limit_Curve(DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double> masses, const std::vector<double>& certainties, unsigned int threads = 1);
+	// Limits for a list of masses and certainty levels, with -1 where no limit is found
+	// After each mass, progress gets its index and limits. Once stop returns true, no mass is started.
+	std::vector<std::vector<double>> Upper_Limits(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& masses, const std::vector<std::vector<double>>& limit_guesses, const std::vector<double>& certainties, unsigned int threads, unsigned int coarsening = 1, bool use_checkpoint = true, std::function<void(unsigned int, const std::vector<double>&)> progress = nullptr, std::function<bool()> stop = nullptr);
+	// Adaptive limit curve, bisecting where the log-log curve is not straight (tolerance in decades)
+	std::vector<std::vector<double>> Upper_Limit_Curve_Adaptive(DM_Particle& DM, DM_Distribution& DM_distr, double mass_min, double mass_max, unsigned int initial_masses = 10, double certainty = 0.95, double tolerance = 0.02, unsigned int refinements = 6, unsigned int threads = 1);
+	// The grid is refined wherever any of the curves requires it.
+	std::vector<std::vector<std::vector<double>>> Upper_Limit_Curve_Adaptive(DM_Particle& DM, DM_Distribution& DM_distr, double mass_min, double mass_max, unsigned int initial_masses, const std::vector<double>& certainties, double tolerance = 0.02, unsigned int refinements = 6, unsigned int threads = 1);
+	// Progressive limit curve: coarse pass, full pass, and adaptive refinements within the time budget
+	// After every pass, the callback receives the curve and the number of the pass.
+	std::vector<std::vector<double>> Upper_Limit_Curve_Progressive(DM_Particle& DM, DM_Distribution& DM_distr, double mass_min, double mass_max, std::function<void(const std::vector<std::vector<double>>&, unsigned int)> callback = nullptr, unsigned int initial_masses = 5, double certainty = 0.95, double tolerance = 0.02, unsigned int refinements = 6, double time_budget = 0.0, unsigned int coarsening = 4, unsigned int threads = 1);
+
+	// Expected limits from background-only toys: {-2sigma, -1sigma, median, +1sigma, +2sigma}
+	std::vector<double> Expected_Limits(DM_Particle& DM, DM_Distribution& DM_distr, double certainty = 0.95, unsigned int toys = 1000, unsigned long int seed = 42, unsigned int threads = 1);
+	std::vector<std::vector<double>> Expected_Limit_Curve(DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double> masses, double certainty = 0.95, unsigned int toys = 1000, unsigned long int seed = 42, unsigned int threads = 1);
+	// Asimov median expected limit of (binned) Poisson statistics without CLs
+	// With Feldman-Cousins intervals, the Asimov events are rounded to integers.
+	double Asimov_Limit(DM_Particle& DM, DM_Distribution& DM_distr, double certainty = 0.95);
+
+	// Asimov limits for every combination {(exposure_1, background_1), (exposure_1, background_2), ...}
+	// Binned backgrounds are distributed like the detector's expected background, or evenly.
+	std::vector<std::vector<std::vector<double>>> Projected_Limit_Curves(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& masses, const std::vector<double>& exposures, const std::vector<double>& backgrounds, double certainty = 0.95, unsigned int threads = 1);
 
 	virtual void Print_Summary(int MPI_rank = 0) const { Print_Summary_Base(MPI_rank); };
 };
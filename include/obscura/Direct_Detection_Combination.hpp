@@ -0,0 +1,53 @@
+#ifndef __Direct_Detection_Combination_hpp_
+#define __Direct_Detection_Combination_hpp_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "obscura/DM_Distribution.hpp"
+#include "obscura/DM_Particle.hpp"
+#include "obscura/Direct_Detection.hpp"
+
+namespace obscura
+{
+
+// Combination of independent detectors with (binned) Poisson statistics and the same targets
+// Upper limits follow from the asymptotic likelihood ratio of the joint likelihood [Cowan2011].
+class DM_Detector_Combination
+{
+  private:
+	std::string targets;
+	// Members without signals at the current mass contribute their background-only likelihood.
+	std::vector<std::unique_ptr<DM_Detector>> detectors;
+
+	// Each member has its own copies of the DM particle and distribution, to be evaluated in parallel.
+	void Set_Fiducial_Values(DM_Particle& DM, DM_Distribution& DM_distr, unsigned int threads);
+	void Reset_Fiducial_Values();
+	double Fiducial_Log_Likelihood(DM_Particle& DM, DM_Distribution& DM_distr);
+
+  public:
+	std::string name;
+	DM_Detector_Combination(std::string label, const std::vector<DM_Detector*>& members = {});
+
+	void Add_Detector(const DM_Detector& detector);
+	unsigned int Number_of_Detectors() const;
+	std::string Target_Particles() const;
+
+	double Minimum_DM_Mass(DM_Particle& DM, const DM_Distribution& DM_distr) const;
+
+	// Statistics
+	// The members can be distributed over multiple threads (0 uses all hardware threads).
+	double Log_Likelihood(DM_Particle& DM, DM_Distribution& DM_distr, unsigned int threads = 1);
+
+	// Limits/Constraints
+	// Coupling above the best fit where 2 * (ln L_max - ln L) reaches the one-sided critical value
+	double Upper_Limit(DM_Particle& DM, DM_Distribution& DM_distr, double certainty = 0.95, unsigned int threads = 1);
+	std::vector<std::vector<double>> Upper_Limit_Curve(DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double> masses, double certainty = 0.95, unsigned int threads = 1);
+
+	void Print_Summary(int MPI_rank = 0) const;
+};
+
+}	// namespace obscura
+
+#endif
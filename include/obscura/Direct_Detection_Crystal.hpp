@@ -13,9 +13,12 @@ namespace obscura
 {
 
 // 1. Event spectra and rates
-extern double dRdEe_Crystal(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal);
-extern double R_Q_Crystal(int Q, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal);
-extern double R_total_Crystal(int Qthreshold, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal);
+// For quick estimates, only every q_stride-th point of the crystal's momentum grid can be used.
+extern double dRdEe_Crystal(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal, unsigned int q_stride = 1);
+// Spectrum at a list of energies, which runs through the momentum grid only once.
+extern std::vector<double> dRdEe_Crystal(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal, unsigned int q_stride = 1);
+extern double R_Q_Crystal(int Q, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal, unsigned int q_stride = 1);
+extern double R_total_Crystal(int Qthreshold, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal, unsigned int q_stride = 1);
 
 // 2. Electron recoil direct detection experiment with semiconductor target
 class DM_Detector_Crystal : public DM_Detector
@@ -37,11 +40,14 @@ class DM_Detector_Crystal : public DM_Detector
 	DM_Detector_Crystal();
 	DM_Detector_Crystal(std::string label, double expo, std::string crys);
 
+	virtual DM_Detector_Crystal* Clone() const override { return new DM_Detector_Crystal(*this); };
+
 	// DM functions
 	virtual double Maximum_Energy_Deposit(DM_Particle& DM, const DM_Distribution& DM_distr) const override;
 	virtual double Minimum_DM_Speed(DM_Particle& DM) const override;
 	virtual double Minimum_DM_Mass(DM_Particle& DM, const DM_Distribution& DM_distr) const override;
 	virtual double dRdE(double E, const DM_Particle& DM, DM_Distribution& DM_distr) override;
+	virtual std::vector<double> dRdE_Batch(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr) override;
 	virtual double DM_Signals_Total(const DM_Particle& DM, DM_Distribution& DM_distr) override;
 	virtual std::vector<double> DM_Signals_Binned(const DM_Particle& DM, DM_Distribution& DM_distr) override;
 
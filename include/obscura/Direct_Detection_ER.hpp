@@ -5,9 +5,11 @@
 
 namespace obscura
 {
-//1. Event spectra and rates
-extern double dRdEe_Ionization_ER(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, double m_nucleus, Atomic_Electron& shell);
-extern double dRdEe_Ionization_ER(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, Atom& atom);
+//1. Event spectra and rates, integrated on a logarithmic grid of q_points
+extern double dRdEe_Ionization_ER(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, double m_nucleus, Atomic_Electron& shell, unsigned int q_points = 100);
+extern double dRdEe_Ionization_ER(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, Atom& atom, unsigned int q_points = 100);
+// Spectrum at a list of energies, where the q grid does not depend on the energy and is shared.
+extern std::vector<double> dRdEe_Ionization_ER(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr, double m_nucleus, Atomic_Electron& shell, unsigned int q_points = 100);
 
 //2. Detector class for ionization experiments from DM-electron scatterings.
 class DM_Detector_Ionization_ER : public DM_Detector_Ionization
@@ -17,7 +19,10 @@ class DM_Detector_Ionization_ER : public DM_Detector_Ionization
 	DM_Detector_Ionization_ER(std::string label, double expo, std::string atom);
 	DM_Detector_Ionization_ER(std::string label, double expo, std::vector<std::string> atoms, std::vector<double> mass_fractions = {});
 
+	virtual DM_Detector_Ionization_ER* Clone() const override { return new DM_Detector_Ionization_ER(*this); };
+
 	virtual double dRdE_Ionization(double E, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& nucleus, Atomic_Electron& shell) override;
+	virtual std::vector<double> dRdE_Ionization_Batch(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& nucleus, Atomic_Electron& shell) override;
 };
 
 }	// namespace obscura
@@ -43,18 +43,23 @@ class DM_Detector_Ionization : public DM_Detector
 	DM_Detector_Ionization(std::string label, double expo, std::string target_particles, std::string atom);
 	DM_Detector_Ionization(std::string label, double expo, std::string target_particles, std::vector<std::string> atoms, std::vector<double> mass_fractions = {});
 
+	virtual DM_Detector_Ionization* Clone() const override { return new DM_Detector_Ionization(*this); };
+
 	// DM functions from the base class
 	virtual double Maximum_Energy_Deposit(DM_Particle& DM, const DM_Distribution& DM_distr) const override;
 	virtual double Minimum_DM_Speed(DM_Particle& DM) const override;
 	virtual double Minimum_DM_Mass(DM_Particle& DM, const DM_Distribution& DM_distr) const override;
 
 	virtual double dRdE(double E, const DM_Particle& DM, DM_Distribution& DM_distr) override;
+	virtual std::vector<double> dRdE_Batch(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr) override;
 	virtual double DM_Signals_Total(const DM_Particle& DM, DM_Distribution& DM_distr) override;
 	virtual std::vector<double> DM_Signals_Binned(const DM_Particle& DM, DM_Distribution& DM_distr) override;
 
 	// Energy spectrum
 	virtual double dRdE_Ionization(double E, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& nucleus, Atomic_Electron& shell);
 	double dRdE_Ionization(double E, const DM_Particle& DM, DM_Distribution& DM_distr, Atom& atom);
+	// Spectrum of one shell at a list of energies
+	virtual std::vector<double> dRdE_Ionization_Batch(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& nucleus, Atomic_Electron& shell);
 
 	// Electron spectrum
 	double R_ne(unsigned int ne, const DM_Particle& DM, DM_Distribution& DM_distr, double W, const Nucleus& nucleus, Atomic_Electron& shell);
@@ -18,6 +18,8 @@ class DM_Detector_Ionization_Migdal : public DM_Detector_Ionization
 	DM_Detector_Ionization_Migdal(std::string label, double expo, std::string atom);
 	DM_Detector_Ionization_Migdal(std::string label, double expo, std::vector<std::string> atoms, std::vector<double> mass_fractions = {});
 
+	virtual DM_Detector_Ionization_Migdal* Clone() const override { return new DM_Detector_Ionization_Migdal(*this); };
+
 	virtual double dRdE_Ionization(double E, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& nucleus, Atomic_Electron& shell) override;
 };
 
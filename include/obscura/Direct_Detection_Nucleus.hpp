@@ -17,6 +17,9 @@ namespace obscura
 // 1. Theoretical nuclear recoil spectrum [events per time, energy, and target mass]
 extern double dRdER_Nucleus(double ER, const DM_Particle& DM, DM_Distribution& DM_distr, const Isotope& target_isotope);
 extern double dRdER_Nucleus(double ER, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& target_nucleus);
+// Spectrum at a list of recoil energies, which shares the maximum DM speed and the prefactors.
+extern std::vector<double> dRdER_Nucleus(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr, const Isotope& target_isotope);
+extern std::vector<double> dRdER_Nucleus(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& target_nucleus);
 
 // 2. Nuclear recoil direct detection experiment
 class DM_Detector_Nucleus : public DM_Detector
@@ -35,6 +38,8 @@ class DM_Detector_Nucleus : public DM_Detector
 	DM_Detector_Nucleus();
 	DM_Detector_Nucleus(std::string label, double expo, std::vector<Nucleus> nuclei, std::vector<double> abund = {});
 
+	virtual DM_Detector_Nucleus* Clone() const override { return new DM_Detector_Nucleus(*this); };
+
 	void Set_Resolution(double res);
 	void Import_Efficiency(std::string filename, double dim);
 	void Import_Efficiency(std::vector<std::string> filenames, double dim);
@@ -43,6 +48,7 @@ class DM_Detector_Nucleus : public DM_Detector
 	virtual double Minimum_DM_Speed(DM_Particle& DM) const override;
 	virtual double Minimum_DM_Mass(DM_Particle& DM, const DM_Distribution& DM_distr) const override;
 	virtual double dRdE(double E, const DM_Particle& DM, DM_Distribution& DM_distr) override;
+	virtual std::vector<double> dRdE_Batch(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr) override;
 
 	virtual void Print_Summary(int MPI_rank = 0) const override;
 };
@@ -0,0 +1,95 @@
+#ifndef __Global_Fit_hpp_
+#define __Global_Fit_hpp_
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "obscura/DM_Halo_Models.hpp"
+#include "obscura/DM_Particle.hpp"
+#include "obscura/Direct_Detection.hpp"
+
+namespace obscura
+{
+
+// Free parameter of a global fit with a flat prior within [minimum, maximum] (in log10 if log_scale)
+// Names: "mDM", "coupling", "rho", "v0", "vesc", "vObserver", and "eta", "beta" for the SHM++
+struct Fit_Parameter
+{
+	std::string name;
+	double minimum, maximum;
+	bool log_scale;
+
+	Fit_Parameter(std::string parameter_name, double min, double max, bool log = false);
+};
+
+// Affine-invariant ensemble sampler [Goodman2010] for global fits of DM and halo parameters
+// The two halves of the ensemble are updated in parallel [ForemanMackey2013].
+class Ensemble_Sampler
+{
+  private:
+	std::vector<Fit_Parameter> parameters;
+	int coupling_index;
+	std::string targets;
+
+	// Every walker owns a DM particle, halo model, and detectors for its position and for proposals.
+	// Moves of the coupling alone only re-scale the detectors' fiducial signals.
+	struct Walker
+	{
+		std::vector<double> position;
+		double log_posterior;
+		std::unique_ptr<DM_Particle> DM;
+		std::unique_ptr<Standard_Halo_Model> halo;
+		std::vector<std::unique_ptr<DM_Detector>> detectors;
+		std::unique_ptr<DM_Particle> DM_proposal;
+		std::unique_ptr<Standard_Halo_Model> halo_proposal;
+		std::vector<std::unique_ptr<DM_Detector>> detectors_proposal;
+		std::mt19937_64 generator;
+		unsigned long int proposals, accepted_proposals, spectra;
+	};
+	std::vector<Walker> walkers;
+	double stretch_scale;
+	unsigned int coupling_moves;
+
+	bool walkers_evaluated;
+	unsigned long int steps;
+	std::vector<std::vector<double>> chain;
+
+	double Parameter_Value(unsigned int i, double x) const;
+	void Set_Parameters(DM_Particle& DM, Standard_Halo_Model& halo, const std::vector<double>& position) const;
+	bool Within_Prior(const std::vector<double>& position) const;
+	double Log_Likelihood(DM_Particle& DM, Standard_Halo_Model& halo, std::vector<std::unique_ptr<DM_Detector>>& detectors) const;
+	void Evaluate_Walker(Walker& walker);
+
+	// Stretch move of a walker within the given dimensions, with a partner from the other half
+	bool Stretch_Move(unsigned int walker, unsigned int first_partner, unsigned int partners, const std::vector<unsigned int>& dimensions);
+	void Sweep(const std::vector<unsigned int>& dimensions, unsigned int threads);
+
+  public:
+	// The walkers start uniformly within the priors. Each step moves the coupling coupling_moves times.
+	Ensemble_Sampler(const std::vector<Fit_Parameter>& fit_parameters, const DM_Particle& DM, const Standard_Halo_Model& halo, const std::vector<DM_Detector*>& detectors, unsigned int number_of_walkers = 32, unsigned long int seed = 42, double a = 2.0, unsigned int coupling_moves_per_step = 10);
+
+	// Alternatively, the walkers start in a ball around the given position (relative width).
+	void Initialize_Walkers(const std::vector<double>& position, double relative_width = 0.01);
+
+	// Run the sampler and append the walkers' positions after every step to the file, if given.
+	// The walkers can be distributed over multiple threads (0 uses all hardware threads).
+	void Run(unsigned int number_of_steps, const std::string& chain_file = "", unsigned int threads = 1);
+
+	unsigned int Number_of_Walkers() const;
+	unsigned long int Number_of_Steps() const;
+	double Acceptance_Fraction() const;
+	// Number of likelihood evaluations which computed a new spectrum
+	unsigned long int Number_of_Spectra() const;
+
+	// Chain entries {step, walker, parameters..., log posterior}, dropping the first burn_in steps.
+	std::vector<std::vector<double>> Chain(unsigned int burn_in = 0) const;
+	std::vector<double> Best_Fit() const;
+
+	void Print_Summary(int MPI_rank = 0) const;
+};
+
+}	// namespace obscura
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef __Multithreading_hpp_
+#define __Multithreading_hpp_
+
+#include <functional>
+
+namespace obscura
+{
+
+// Number of worker threads, where 0 corresponds to all available hardware threads.
+extern unsigned int Number_of_Threads(unsigned int threads = 0);
+
+// Distribute the tasks 0, ..., N-1 dynamically over a pool of worker threads.
+// The task function receives the task index and the index of the worker running it.
+extern void Parallel_For(unsigned int tasks, unsigned int threads, const std::function<void(unsigned int, unsigned int)>& task);
+
+}	// namespace obscura
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef __Statistical_Methods_hpp_
+#define __Statistical_Methods_hpp_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace obscura
+{
+
+// 1. Maximum gap method a'la Yellin [arXiv:physics/0203002]
+// Probability that the maximum gap is smaller than x for an expected number of events mu.
+// Summed in extended precision, with the asymptotic distribution for large mu.
+extern double CDF_Maximum_Gap(double x, double mu);
+
+// Tabulation of CDF_Maximum_Gap on a grid of log10(mu) and w = x - ln(1+mu).
+// Outside the grid and in cells with an error above the tolerance, the CDF is evaluated directly.
+class CDF_Maximum_Gap_Table
+{
+  private:
+	double log10_mu_min, log10_mu_max, w_min, w_max, tolerance;
+	unsigned int mu_points, w_points;
+	double delta_log10_mu, delta_w;
+	std::vector<std::vector<double>> table;
+	std::vector<std::vector<bool>> accurate_cells;
+
+	double Gap(double log10_mu, double w) const;
+	double Interpolate(unsigned int i, unsigned int j, double log10_mu, double w) const;
+	void Check_Interpolation_Error(unsigned int threads);
+
+  public:
+	CDF_Maximum_Gap_Table(double mu_min = 0.01, double mu_max = 1000.0, unsigned int N_mu = 251, double wmin = -5.0, double wmax = 20.0, unsigned int N_w = 201, double tol = 1.0e-6, unsigned int threads = 1);
+	explicit CDF_Maximum_Gap_Table(const std::string& filename);
+
+	double operator()(double x, double mu) const;
+
+	double Fraction_of_Accurate_Cells() const;
+
+	void Export(const std::string& filename) const;
+};
+
+// Tabulated CDF shared by all maximum gap analyses and cached in the data directory.
+extern double CDF_Maximum_Gap_Tabulated(double x, double mu);
+
+// P value of the maximum gap method given the expected signals in the gaps between the events.
+extern double P_Value_Maximum_Gap(const std::vector<double>& gaps);
+
+// 2. Optimum interval method a'la Yellin [arXiv:physics/0203002]
+// Largest signal fraction of an interval with at most n events (n = 0, ..., n_max), given the gaps
+extern std::vector<double> Optimum_Interval_Fractions(const std::vector<double>& gaps, unsigned int n_max);
+
+// Monte Carlo tables of C_n(x, mu) and of the distribution of C_max on a grid of mu
+class Optimum_Interval_Table
+{
+  private:
+	double log10_mu_min, log10_mu_max;
+	unsigned int mu_points, n_max, toys, quantiles_intervals, quantiles_C_max;
+	unsigned long int seed;
+	double delta_log10_mu;
+	std::vector<std::vector<std::vector<double>>> interval_quantiles;
+	std::vector<std::vector<double>> C_max_quantiles;
+
+	void Generate_Grid_Point(unsigned int i);
+	double P_Value_Grid_Point(unsigned int i, const std::vector<double>& fractions) const;
+
+  public:
+	Optimum_Interval_Table(double mu_min = 0.1, double mu_max = 1000.0, unsigned int N_mu = 61, unsigned int n_maximum = 50, unsigned int N_toys = 5000, unsigned long int random_seed = 42, unsigned int threads = 1);
+	explicit Optimum_Interval_Table(const std::string& filename);
+
+	double Minimum_Mu() const;
+	double Maximum_Mu() const;
+	unsigned int Maximum_Events() const;
+
+	// C_max of the given interval fractions and the probability of a larger value for mu
+	double C_Max(const std::vector<double>& fractions, double mu) const;
+	double P_Value(const std::vector<double>& fractions, double mu) const;
+
+	void Export(const std::string& filename) const;
+};
+
+// P value of the optimum interval method given the expected signals in the gaps between the events.
+// The table is cached in the data directory. Outside its range of mu, the maximum gap is used.
+extern double P_Value_Optimum_Interval(const std::vector<double>& gaps);
+
+// 3. Feldman-Cousins confidence belts with known background [arXiv:physics/9711021]
+// The acceptance regions are computed on a grid of the signal expectation value mu.
+class Feldman_Cousins_Belt
+{
+  private:
+	double background, certainty, delta_mu;
+	unsigned int n_max, mu_points;
+	std::vector<unsigned long int> acceptance_min, acceptance_max;
+
+	void Acceptance_Region(unsigned int i);
+
+  public:
+	Feldman_Cousins_Belt(double b, double CL = 0.9, unsigned int n_maximum = 100, double mu_step = 0.005, unsigned int threads = 1);
+	explicit Feldman_Cousins_Belt(const std::string& filename);
+
+	double Background() const;
+	double Certainty_Level() const;
+	unsigned int Maximum_Events() const;
+
+	// Confidence interval [Lower_Limit(n), Upper_Limit(n)] for mu given n observed events.
+	double Lower_Limit(unsigned long int n) const;
+	double Upper_Limit(unsigned long int n) const;
+
+	void Export(const std::string& filename) const;
+};
+
+// Upper limit on the signal expectation value. Each belt is generated once per process.
+// The belts of standard certainty levels and backgrounds are cached in the data directory.
+extern double Feldman_Cousins_Upper_Limit(unsigned long int n, double b, double certainty);
+// Probability of n and all event numbers ranked below it
+// The belt at certainty level CL accepts n for exactly those mu with a P value above 1 - CL.
+extern double P_Value_Feldman_Cousins(unsigned long int n, double mu, double b);
+
+// 4. Likelihood ratio of a signal strength r, ln L(r) = -r * S + sum_k w_k * ln(r * s_k + b_k)
+// The terms k are bins (w_k = observed events) or unbinned events (w_k = 1).
+extern double Log_Likelihood_Signal_Strength(double r, double signals, const std::vector<double>& weights, const std::vector<double>& signal_terms, const std::vector<double>& background_terms);
+extern double Best_Fit_Signal_Strength(double signals, const std::vector<double>& weights, const std::vector<double>& signal_terms, const std::vector<double>& background_terms);
+// Maximum of a unimodal function on [x_min, x_max] by golden section search
+extern double Golden_Section_Maximum(const std::function<double(double)>& func, double x_min, double x_max, double tolerance);
+// One-sided test statistic q(r) = 2 * (ln L(r_best) - ln L(r)) for r_best < r, and 0 otherwise
+extern double Test_Statistic_Signal_Strength(double r, double signals, const std::vector<double>& weights, const std::vector<double>& signal_terms, const std::vector<double>& background_terms);
+
+// 5. Bayesian upper limit on r with the prior(r) ~ r^prior_exponent for r > r_min
+// Flat prior: prior_exponent = 0, log prior: prior_exponent = -1 with r_min > 0
+extern double Bayesian_Upper_Limit_Signal_Strength(double certainty, double signals, const std::vector<double>& weights, const std::vector<double>& signal_terms, const std::vector<double>& background_terms, double prior_exponent = 0.0, double r_min = 0.0);
+
+}	// namespace obscura
+
+#endif
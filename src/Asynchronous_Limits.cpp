@@ -0,0 +1,167 @@
+#include "obscura/Asynchronous_Limits.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace obscura
+{
+
+struct Asynchronous_Limit_Curve::State
+{
+	std::vector<double> masses;
+	std::vector<double> certainties;
+	std::vector<std::vector<double>> upper_limits;
+	std::vector<bool> completed;
+	unsigned int completed_masses = 0;
+	bool finished				  = false;
+
+	std::atomic<bool> cancelled;
+	std::atomic<bool> time_budget_exceeded;
+
+	mutable std::mutex mutex;
+	std::condition_variable finished_condition;
+
+	State() : cancelled(false), time_budget_exceeded(false) {}
+};
+
+static std::function<void(double, const std::vector<double>&, unsigned int, unsigned int)> First_Level_Callback(std::function<void(double, double, unsigned int, unsigned int)> callback)
+{
+	if(!callback)
+		return nullptr;
+	return [callback](double mass, const std::vector<double>& limits, unsigned int completed, unsigned int total) {
+		callback(mass, limits[0], completed, total);
+	};
+}
+
+Asynchronous_Limit_Curve::Asynchronous_Limit_Curve(const DM_Detector& detector, const DM_Particle& DM, const DM_Distribution& DM_distr, const std::vector<double>& masses, double certainty, unsigned int threads, std::function<void(double, double, unsigned int, unsigned int)> callback, double time_budget)
+: Asynchronous_Limit_Curve(detector, DM, DM_distr, masses, std::vector<double> {certainty}, threads, First_Level_Callback(callback), time_budget)
+{
+}
+
+Asynchronous_Limit_Curve::Asynchronous_Limit_Curve(const DM_Detector& detector, const DM_Particle& DM, const DM_Distribution& DM_distr, const std::vector<double>& masses, const std::vector<double>& certainties, unsigned int threads, std::function<void(double, const std::vector<double>&, unsigned int, unsigned int)> callback, double time_budget)
+: state(std::make_shared<State>())
+{
+	auto start_time = std::chrono::steady_clock::now();
+
+	state->masses		= masses;
+	state->certainties	= certainties;
+	state->upper_limits = std::vector<std::vector<double>>(masses.size(), std::vector<double>(certainties.size(), -1.0));
+	state->completed	= std::vector<bool>(masses.size(), false);
+
+	// The copies are made on the calling thread, which can change the originals right after.
+	std::shared_ptr<DM_Detector> detector_copy(detector.Clone());
+	std::shared_ptr<DM_Particle> DM_copy(DM.Clone());
+	std::shared_ptr<DM_Distribution> DM_distr_copy(DM_distr.Clone());
+	std::shared_ptr<State> shared_state = state;
+
+	auto compute = [shared_state, detector_copy, DM_copy, DM_distr_copy, threads, callback, time_budget, start_time]() {
+		std::function<void(unsigned int, const std::vector<double>&)> progress = [&shared_state, &callback](unsigned int i, const std::vector<double>& limits) {
+			unsigned int completed_masses;
+			{
+				std::lock_guard<std::mutex> lock(shared_state->mutex);
+				shared_state->upper_limits[i] = limits;
+				shared_state->completed[i]	  = true;
+				completed_masses			  = ++shared_state->completed_masses;
+			}
+			// The callback may query the progress and partial results, so it must not hold the state's lock.
+			if(callback)
+				callback(shared_state->masses[i], limits, completed_masses, shared_state->masses.size());
+		};
+		std::function<bool()> stop = [&shared_state, time_budget, start_time]() {
+			if(time_budget > 0.0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count() > time_budget)
+				shared_state->time_budget_exceeded = true;
+			return shared_state->cancelled || shared_state->time_budget_exceeded;
+		};
+		std::vector<std::vector<double>> limit_guesses(shared_state->masses.size(), std::vector<double>(shared_state->certainties.size(), -1.0));
+		detector_copy->Upper_Limits(*DM_copy, *DM_distr_copy, shared_state->masses, limit_guesses, shared_state->certainties, threads, 1, true, progress, stop);
+		std::lock_guard<std::mutex> lock(shared_state->mutex);
+		shared_state->finished = true;
+		shared_state->finished_condition.notify_all();
+	};
+	thread = std::thread(compute);
+}
+
+Asynchronous_Limit_Curve::~Asynchronous_Limit_Curve()
+{
+	if(thread.joinable())
+	{
+		Cancel();
+		thread.join();
+	}
+}
+
+void Asynchronous_Limit_Curve::Cancel()
+{
+	state->cancelled = true;
+}
+
+bool Asynchronous_Limit_Curve::Cancelled() const
+{
+	return state->cancelled;
+}
+
+bool Asynchronous_Limit_Curve::Time_Budget_Exceeded() const
+{
+	return state->time_budget_exceeded;
+}
+
+bool Asynchronous_Limit_Curve::Finished() const
+{
+	std::lock_guard<std::mutex> lock(state->mutex);
+	return state->finished;
+}
+
+void Asynchronous_Limit_Curve::Wait()
+{
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->finished_condition.wait(lock, [this] { return state->finished; });
+}
+
+bool Asynchronous_Limit_Curve::Wait_For(double seconds)
+{
+	std::unique_lock<std::mutex> lock(state->mutex);
+	return state->finished_condition.wait_for(lock, std::chrono::duration<double>(seconds), [this] { return state->finished; });
+}
+
+unsigned int Asynchronous_Limit_Curve::Number_of_Masses() const
+{
+	return state->masses.size();
+}
+
+unsigned int Asynchronous_Limit_Curve::Completed_Masses() const
+{
+	std::lock_guard<std::mutex> lock(state->mutex);
+	return state->completed_masses;
+}
+
+std::vector<std::vector<double>> Asynchronous_Limit_Curve::Partial_Limit_Curve() const
+{
+	return Partial_Limit_Curves()[0];
+}
+
+std::vector<std::vector<std::vector<double>>> Asynchronous_Limit_Curve::Partial_Limit_Curves() const
+{
+	std::lock_guard<std::mutex> lock(state->mutex);
+	std::vector<std::vector<std::vector<double>>> limits(state->certainties.size());
+	for(unsigned int j = 0; j < state->certainties.size(); j++)
+		for(unsigned int i = 0; i < state->masses.size(); i++)
+			if(state->completed[i] && state->upper_limits[i][j] > 0.0)
+				limits[j].push_back(std::vector<double> {state->masses[i], state->upper_limits[i][j]});
+	return limits;
+}
+
+std::vector<std::vector<double>> Asynchronous_Limit_Curve::Get()
+{
+	Wait();
+	return Partial_Limit_Curve();
+}
+
+std::vector<std::vector<std::vector<double>>> Asynchronous_Limit_Curve::Get_Limit_Curves()
+{
+	Wait();
+	return Partial_Limit_Curves();
+}
+
+}	// namespace obscura
@@ -1,6 +1,12 @@
 #include "obscura/Configuration.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
+#include <iomanip>
+#include <sstream>
 #include <sys/stat.h>	 //required to create a folder
 #include <sys/types.h>	 // required for stat.h
 
@@ -21,6 +27,19 @@ namespace obscura
 using namespace libconfig;
 using namespace libphysica::natural_units;
 
+// Shortest label of a certainty level in percent, which keeps all its given digits.
+static std::string Certainty_Level_Label(double certainty)
+{
+	char label[32];
+	for(int decimals = 0; decimals <= 12; decimals++)
+	{
+		std::snprintf(label, sizeof(label), "%.*f", decimals, 100.0 * certainty);
+		if(std::fabs(std::atof(label) - 100.0 * certainty) <= 1.0e-10 * certainty)
+			break;
+	}
+	return std::string(label);
+}
+
 // Read in the configuration file
 Configuration::Configuration()
 : ID("default")
@@ -32,6 +51,7 @@ Configuration::Configuration(std::string cfg_filename, int MPI_rank)
 {
 	// 1. Read the cfg file.
 	Read_Config_File();
+	Compute_Configuration_Hash();
 
 	// 2. Find the run ID, create a folder and copy the cfg file.
 	Initialize_Result_Folder(MPI_rank);
@@ -116,14 +136,24 @@ void Configuration::Print_Summary_Base(int MPI_rank)
 				  << "Summary of obscura configuration" << std::endl
 				  << std::endl
 				  << "Config file:\t" << cfg_file << std::endl
-				  << "ID:\t\t" << ID << std::endl;
+				  << "ID:\t\t" << ID << std::endl
+				  << "Configuration hash:\t" << configuration_hash << std::endl;
 		DM->Print_Summary(MPI_rank);
 		DM_distr->Print_Summary(MPI_rank);
 		DM_detector->Print_Summary(MPI_rank);
 		std::cout << "Direct detection constraints" << std::endl
-				  << "\tCertainty level [%]:\t" << 100.0 * constraints_certainty << std::endl
+				  << "\tCertainty level [%]:\t";
+		for(unsigned int i = 0; i < constraints_certainties.size(); i++)
+			std::cout << ((i > 0) ? ", " : "") << 100.0 * constraints_certainties[i];
+		std::cout << std::endl
 				  << "\tMass range [GeV]:\t[" << constraints_mass_min << "," << constraints_mass_max << "]" << std::endl
-				  << "\tMass steps:\t\t" << constraints_masses
+				  << "\tMass steps:\t\t" << constraints_masses << std::endl
+				  << "\tAdaptive mass grid:\t" << (constraints_adaptive ? "[x]" : "[ ]") << std::endl;
+		if(constraints_adaptive)
+			std::cout << "\t\tTolerance [dex]:\t" << constraints_tolerance << std::endl
+					  << "\t\tRefinements:\t\t" << constraints_refinements << std::endl;
+		std::cout << "\tCheckpoint:\t\t" << (constraints_checkpoint ? "[x]" : "[ ]") << std::endl
+				  << "\tThreads:\t\t" << constraints_threads
 				  << SEPARATOR
 				  << std::endl;
 	}
@@ -147,6 +177,54 @@ void Configuration::Read_Config_File()
 	}
 }
 
+// Canonical representation of a setting and its children, independent of comments and formatting
+static std::string Setting_String(const Setting& setting)
+{
+	std::ostringstream output;
+	output << std::setprecision(17);
+	if(setting.getName() != nullptr)
+		output << setting.getName() << "=";
+	switch(setting.getType())
+	{
+		case Setting::TypeInt:
+			output << static_cast<int>(setting);
+			break;
+		case Setting::TypeInt64:
+			output << static_cast<long long>(setting);
+			break;
+		case Setting::TypeFloat:
+			output << static_cast<double>(setting);
+			break;
+		case Setting::TypeString:
+			output << "\"" << static_cast<const char*>(setting) << "\"";
+			break;
+		case Setting::TypeBoolean:
+			output << (static_cast<bool>(setting) ? "true" : "false");
+			break;
+		default:
+			output << "(";
+			for(int i = 0; i < setting.getLength(); i++)
+				if(setting[i].getName() == nullptr || std::string(setting[i].getName()) != "constraints_threads")
+					output << Setting_String(setting[i]) << ";";
+			output << ")";
+	}
+	return output.str();
+}
+
+void Configuration::Compute_Configuration_Hash()
+{
+	// 64-bit FNV-1a hash, which is identical on all platforms and compilers.
+	unsigned long long int hash = 14695981039346656037ULL;
+	for(unsigned char c : Setting_String(config.getRoot()))
+	{
+		hash ^= c;
+		hash *= 1099511628211ULL;
+	}
+	std::ostringstream output;
+	output << std::hex << std::setw(16) << std::setfill('0') << hash;
+	configuration_hash = output.str();
+}
+
 void Configuration::Construct_DM_Particle()
 {
 	double DM_mass, DM_spin, DM_fraction;
@@ -774,15 +852,39 @@ void Configuration::Construct_DM_Detector_Crystal()
 
 void Configuration::Initialize_Parameters()
 {
+	// The certainty level can also be a list of levels, e.g. [0.9, 0.95], whose limits share the spectra.
 	try
 	{
-		constraints_certainty = config.lookup("constraints_certainty");
+		const Setting& certainty = config.lookup("constraints_certainty");
+		constraints_certainties.clear();
+		if(certainty.isAggregate())
+			for(int i = 0; i < certainty.getLength(); i++)
+				constraints_certainties.push_back(static_cast<double>(certainty[i]));
+		else
+			constraints_certainties.push_back(static_cast<double>(certainty));
 	}
 	catch(const SettingNotFoundException& nfex)
 	{
 		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in Configuration::Initialize_Parameters(): No 'constraints_certainty' setting in configuration file." << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
+	if(constraints_certainties.empty())
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in Configuration::Initialize_Parameters(): The list 'constraints_certainty' is empty." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	constraints_certainty = constraints_certainties[0];
+	constraints_certainty_labels.clear();
+	for(auto& certainty : constraints_certainties)
+	{
+		std::string label = Certainty_Level_Label(certainty);
+		if(std::find(constraints_certainty_labels.begin(), constraints_certainty_labels.end(), label) != constraints_certainty_labels.end())
+		{
+			std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in Configuration::Initialize_Parameters(): The certainty level " << label << "% appears more than once in 'constraints_certainty'." << std::endl;
+			std::exit(EXIT_FAILURE);
+		}
+		constraints_certainty_labels.push_back(label);
+	}
 
 	try
 	{
@@ -813,6 +915,55 @@ void Configuration::Initialize_Parameters()
 		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in Configuration::Initialize_Parameters(): No 'constraints_masses' setting in configuration file." << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
+
+	// Optional setting, the limits are computed serially by default.
+	try
+	{
+		constraints_threads = config.lookup("constraints_threads");
+	}
+	catch(const SettingNotFoundException& nfex)
+	{
+		constraints_threads = 1;
+	}
+
+	// Optional setting, checkpoints are used by default.
+	try
+	{
+		constraints_checkpoint = config.lookup("constraints_checkpoint");
+	}
+	catch(const SettingNotFoundException& nfex)
+	{
+		constraints_checkpoint = true;
+	}
+
+	// Optional settings, the mass grid is uniform by default.
+	try
+	{
+		constraints_adaptive = config.lookup("constraints_adaptive");
+	}
+	catch(const SettingNotFoundException& nfex)
+	{
+		constraints_adaptive = false;
+	}
+	if(constraints_adaptive)
+	{
+		try
+		{
+			constraints_tolerance = config.lookup("constraints_tolerance");
+		}
+		catch(const SettingNotFoundException& nfex)
+		{
+			constraints_tolerance = 0.02;
+		}
+		try
+		{
+			constraints_refinements = config.lookup("constraints_refinements");
+		}
+		catch(const SettingNotFoundException& nfex)
+		{
+			constraints_refinements = 6;
+		}
+	}
 }
 
 }	// namespace obscura
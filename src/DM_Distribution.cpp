@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <iostream>
+#include <typeinfo>
 
 #include "libphysica/Integration.hpp"
 #include "libphysica/Natural_Units.hpp"
@@ -23,6 +24,16 @@ DM_Distribution::DM_Distribution(std::string label, double rhoDM, double vMin, d
 {
 }
 
+DM_Distribution* DM_Distribution::Clone() const
+{
+	if(typeid(*this) != typeid(DM_Distribution))
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Distribution::Clone(): The derived class " << typeid(*this).name() << " does not override Clone()." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	return new DM_Distribution(*this);
+}
+
 double DM_Distribution::Minimum_DM_Speed() const
 {
 	return v_domain[0];
@@ -3,10 +3,12 @@
 #include <cmath>
 #include <functional>
 #include <iostream>
+#include <typeinfo>
 
 #include "libphysica/Integration.hpp"
 #include "libphysica/Natural_Units.hpp"
 #include "libphysica/Statistics.hpp"
+#include "libphysica/Utilities.hpp"
 
 namespace obscura
 {
@@ -23,6 +25,16 @@ DM_Particle::DM_Particle(double m, double s)
 {
 }
 
+DM_Particle* DM_Particle::Clone() const
+{
+	if(typeid(*this) != typeid(DM_Particle))
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Particle::Clone(): The derived class " << typeid(*this).name() << " does not override Clone()." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	return new DM_Particle(*this);
+}
+
 void DM_Particle::Set_Mass(double mDM)
 {
 	// The cross sections might depend on the DM mass, and need to be re-computed to yield the same cross sections.
@@ -1,9 +1,24 @@
 #include "obscura/Direct_Detection.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <numeric>
+#include <random>
+#include <set>
+#include <sstream>
+#include <typeinfo>
+
+#include <boost/math/special_functions/erf.hpp>
+#include <boost/math/special_functions/gamma.hpp>
 
 #include "libphysica/Integration.hpp"
 #include "libphysica/Natural_Units.hpp"
@@ -11,10 +26,79 @@
 #include "libphysica/Statistics.hpp"
 #include "libphysica/Utilities.hpp"
 
+#include "obscura/Multithreading.hpp"
+#include "obscura/Statistical_Methods.hpp"
+
 namespace obscura
 {
 using namespace libphysica::natural_units;
 
+// Tabulated spectrum
+Tabulated_Spectrum::Tabulated_Spectrum()
+: kinematic_endpoint(0.0)
+{
+}
+
+Tabulated_Spectrum::Tabulated_Spectrum(const std::vector<double>& energy_grid, const std::vector<double>& spectrum, double endpoint)
+: energies(energy_grid), interpolation(energy_grid, spectrum), kinematic_endpoint(endpoint)
+{
+	cumulative_signals = {0.0};
+	for(unsigned int i = 1; i < energies.size(); i++)
+		cumulative_signals.push_back(cumulative_signals.back() + interpolation.Integrate(energies[i - 1], energies[i]));
+}
+
+double Tabulated_Spectrum::operator()(double E) const
+{
+	if(energies.empty() || E < energies.front() || E > energies.back())
+		return 0.0;
+	return std::max(0.0, interpolation(E));
+}
+
+double Tabulated_Spectrum::Cumulative_Signals(double E) const
+{
+	if(energies.empty() || E <= energies.front())
+		return 0.0;
+	else if(E >= energies.back())
+		return cumulative_signals.back();
+	unsigned int i = std::upper_bound(energies.begin(), energies.end(), E) - energies.begin() - 1;
+	return cumulative_signals[i] + interpolation.Integrate(energies[i], E);
+}
+
+double Tabulated_Spectrum::Signals(double E_1, double E_2) const
+{
+	return Cumulative_Signals(E_2) - Cumulative_Signals(E_1);
+}
+
+double Tabulated_Spectrum::Total_Signals() const
+{
+	return energies.empty() ? 0.0 : cumulative_signals.back();
+}
+
+double Tabulated_Spectrum::Inverse_Cumulative_Signals(double signals) const
+{
+	if(energies.empty())
+		return 0.0;
+	else if(signals <= 0.0)
+		return energies.front();
+	else if(signals >= cumulative_signals.back())
+		return energies.back();
+	// Linear interpolation of the cumulative signals between the tabulated energies
+	unsigned int j	= std::upper_bound(cumulative_signals.begin(), cumulative_signals.end(), signals) - cumulative_signals.begin();
+	j				= std::min(std::max(j, 1u), static_cast<unsigned int>(cumulative_signals.size() - 1));
+	double fraction	= (cumulative_signals[j] > cumulative_signals[j - 1]) ? (signals - cumulative_signals[j - 1]) / (cumulative_signals[j] - cumulative_signals[j - 1]) : 0.0;
+	return energies[j - 1] + fraction * (energies[j] - energies[j - 1]);
+}
+
+std::vector<double> Tabulated_Spectrum::Energies() const
+{
+	return energies;
+}
+
+double Tabulated_Spectrum::Kinematic_Endpoint() const
+{
+	return kinematic_endpoint;
+}
+
 // DM Detector base class, which provides the statistical methods and energy bins.
 // Statistics
 // Likelihoods
@@ -22,17 +106,37 @@ double DM_Detector::Log_Likelihood(DM_Particle& DM, DM_Distribution& DM_distr)
 {
 	if(statistical_analysis == "Poisson")
 	{
-		double s			= DM_Signals_Total(DM, DM_distr);
+		double s			= using_fiducial_values ? Fiducial_Rescaling_Factor(DM) * fiducial_signals : DM_Signals_Total(DM, DM_distr);
 		unsigned long int n = observed_events;
 		double b			= expected_background;
+		if(profiling_background)
+		{
+			std::vector<double> normalization = Background_Normalizations({s}, Observed_Events(), {b});
+			return libphysica::Log_Likelihood_Poisson(s, n, normalization[0] * b) + Log_Background_Constraint(normalization);
+		}
 		if(b < 1.0e-4 && (n > s)) b = n-s;	// see eq.(29) of [arXiv:1705.07920]
 		return libphysica::Log_Likelihood_Poisson(s, n, b);
 	}
 	else if(statistical_analysis == "Binned Poisson")
 	{
-		std::vector<double> s			 = DM_Signals_Binned(DM, DM_distr);
+		std::vector<double> s;
+		if(using_fiducial_values)
+		{
+			double rescaling_factor = Fiducial_Rescaling_Factor(DM);
+			for(unsigned int i = 0; i < fiducial_spectrum.size(); i++)
+				s.push_back(rescaling_factor * fiducial_spectrum[i]);
+		}
+		else
+			s = DM_Signals_Binned(DM, DM_distr);
 		std::vector<unsigned long int> n = bin_observed_events;
 		std::vector<double> b			 = bin_expected_background;
+		if(profiling_background)
+		{
+			std::vector<double> normalizations = Background_Normalizations(s, Observed_Events(), b);
+			for(unsigned int i = 0; i < b.size(); i++)
+				b[i] *= normalizations[i];
+			return libphysica::Log_Likelihood_Poisson_Binned(s, n, b) + Log_Background_Constraint(normalizations);
+		}
 		for(unsigned int i = 0; i < b.size(); i++)
 		if(b[i] < 1.0e-4 && (n[i] > s[i])) b[i] = n[i]-s[i]; // see eq.(29) of [arXiv:1705.07920]
 		return libphysica::Log_Likelihood_Poisson_Binned(s, n, b);
@@ -41,6 +145,18 @@ double DM_Detector::Log_Likelihood(DM_Particle& DM, DM_Distribution& DM_distr)
 	{
 		return log(P_Value_Maximum_Gap(DM, DM_distr));
 	}
+	else if(statistical_analysis == "Optimum Interval")
+	{
+		return log(P_Value_Optimum_Interval(DM, DM_distr));
+	}
+	else if(statistical_analysis == "Unbinned Likelihood")
+	{
+		if(using_fiducial_values)
+			return Log_Likelihood_Unbinned(fiducial_spectrum, fiducial_signals, Fiducial_Rescaling_Factor(DM));
+		std::vector<double> event_spectrum;
+		double signals = Unbinned_Signals(DM_Spectrum(DM, DM_distr), event_spectrum);
+		return Log_Likelihood_Unbinned(event_spectrum, signals, 1.0);
+	}
 	else
 	{
 		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector_Nucleus::Log_Likelihood(): Analysis " << statistical_analysis << " not recognized." << std::endl;
@@ -53,64 +169,314 @@ double DM_Detector::Likelihood(DM_Particle& DM, DM_Distribution& DM_distr)
 	return exp(Log_Likelihood(DM, DM_distr));
 }
 
-std::vector<std::vector<double>> DM_Detector::Log_Likelihood_Scan(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& masses, const std::vector<double>& couplings)
+std::vector<double> DM_Detector::Log_Likelihoods_Fixed_Mass(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& couplings)
+{
+	// The signals are computed once for a fiducial coupling and re-scaled for all couplings.
+	DM.Set_Interaction_Parameter(*std::max_element(couplings.begin(), couplings.end()), targets);
+	Set_Fiducial_Values(DM, DM_distr);
+	std::vector<double> log_likelihoods;
+	for(auto& coupling : couplings)
+	{
+		DM.Set_Interaction_Parameter(coupling, targets);
+		log_likelihoods.push_back(Log_Likelihood(DM, DM_distr));
+	}
+	Reset_Fiducial_Values();
+	return log_likelihoods;
+}
+
+std::vector<std::vector<double>> DM_Detector::Log_Likelihood_Scan(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& masses, const std::vector<double>& couplings, unsigned int threads)
 {
 	double m_original		 = DM.mass;
 	double coupling_original = DM.Get_Interaction_Parameter(targets);
 	std::vector<std::vector<double>> log_likelihoods;
-	for(auto& mass : masses)
+	if(couplings.empty())
+		return log_likelihoods;
+
+	std::vector<std::vector<double>> log_likelihoods_mass(masses.size());
+	unsigned int workers = std::min(Number_of_Threads(threads), static_cast<unsigned int>(masses.size()));
+	Worker_Copies copies = Copies_For_Workers(DM, DM_distr, workers);
+	Parallel_For(masses.size(), workers, [&log_likelihoods_mass, &masses, &couplings, &copies](unsigned int i, unsigned int worker) {
+		copies.particles[worker]->Set_Mass(masses[i]);
+		log_likelihoods_mass[i] = copies.detectors[worker]->Log_Likelihoods_Fixed_Mass(*copies.particles[worker], *copies.distributions[worker], couplings);
+	});
+	for(unsigned int i = 0; i < masses.size(); i++)
+		for(unsigned int j = 0; j < couplings.size(); j++)
+			log_likelihoods.push_back({masses[i], couplings[j], log_likelihoods_mass[i][j]});
+
+	DM.Set_Mass(m_original);
+	DM.Set_Interaction_Parameter(coupling_original, targets);
+	return log_likelihoods;
+}
+
+std::vector<double> DM_Detector::Log_Likelihoods_Fixed_Mass(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& couplings, double coupling_min, double coupling_max, double& log_likelihood_max)
+{
+	DM.Set_Interaction_Parameter(std::max(coupling_max, *std::max_element(couplings.begin(), couplings.end())), targets);
+	Set_Fiducial_Values(DM, DM_distr);
+	std::vector<double> log_likelihoods;
+	for(auto& coupling : couplings)
 	{
-		DM.Set_Mass(mass);
-		for(auto& coupling : couplings)
+		DM.Set_Interaction_Parameter(coupling, targets);
+		log_likelihoods.push_back(Log_Likelihood(DM, DM_distr));
+	}
+	// The log likelihood is unimodal in the coupling, possibly with its maximum at the boundary.
+	std::function<double(double)> log_likelihood = [this, &DM, &DM_distr](double log10_coupling) {
+		DM.Set_Interaction_Parameter(pow(10.0, log10_coupling), targets);
+		return Log_Likelihood(DM, DM_distr);
+	};
+	double log10_best_fit = Golden_Section_Maximum(log_likelihood, log10(coupling_min), log10(coupling_max), 1.0e-4);
+	log_likelihood_max	  = std::max({log_likelihood(log10_best_fit), log_likelihood(log10(coupling_min)), log_likelihood(log10(coupling_max)), *std::max_element(log_likelihoods.begin(), log_likelihoods.end())});
+	Reset_Fiducial_Values();
+	return log_likelihoods;
+}
+
+// Contour tracing
+std::vector<Likelihood_Contour> DM_Detector::Likelihood_Contours(DM_Particle& DM, DM_Distribution& DM_distr, double mass_min, double mass_max, double coupling_min, double coupling_max, const std::vector<double>& certainty_levels, unsigned int initial_masses, unsigned int initial_couplings, unsigned int refinements, unsigned int threads)
+{
+	if(initial_masses < 2 || initial_couplings < 2 || refinements > 12)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::Likelihood_Contours(): The initial grid needs at least 2 x 2 points (" << initial_masses << " x " << initial_couplings << "), and the number of refinements (" << refinements << ") cannot exceed 12." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	else if(mass_min <= 0.0 || mass_max <= mass_min || coupling_min <= 0.0 || coupling_max <= coupling_min)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::Likelihood_Contours(): The ranges of masses [" << mass_min << "," << mass_max << "] and couplings [" << coupling_min << "," << coupling_max << "] have to be positive and non-empty." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	double m_original		 = DM.mass;
+	double coupling_original = DM.Get_Interaction_Parameter(targets);
+
+	// The points (i, j) of the finest grid, where the initial grid consists of every step-th point.
+	unsigned int step			  = 1 << refinements;
+	std::vector<double> masses	  = libphysica::Log_Space(mass_min, mass_max, (initial_masses - 1) * step + 1);
+	std::vector<double> couplings = libphysica::Log_Space(coupling_min, coupling_max, (initial_couplings - 1) * step + 1);
+	std::map<std::pair<unsigned int, unsigned int>, double> log_likelihoods;
+	double log_likelihood_max = -std::numeric_limits<double>::infinity();
+
+	unsigned int workers = Number_of_Threads(threads);
+	Worker_Copies copies = Copies_For_Workers(DM, DM_distr, workers);
+	// The new points are evaluated one mass at a time, such that the spectrum is computed only once per mass.
+	std::function<void(const std::set<std::pair<unsigned int, unsigned int>>&)> evaluate = [&](const std::set<std::pair<unsigned int, unsigned int>>& points) {
+		std::map<unsigned int, std::vector<unsigned int>> columns;
+		for(auto& point : points)
+			if(log_likelihoods.count(point) == 0)
+				columns[point.first].push_back(point.second);
+		std::vector<unsigned int> mass_indices;
+		for(auto& column : columns)
+			mass_indices.push_back(column.first);
+		std::vector<std::vector<double>> column_log_likelihoods(mass_indices.size());
+		std::vector<double> column_maxima(mass_indices.size());
+		Parallel_For(mass_indices.size(), workers, [&](unsigned int k, unsigned int worker) {
+			std::vector<double> column_couplings;
+			for(auto& j : columns[mass_indices[k]])
+				column_couplings.push_back(couplings[j]);
+			copies.particles[worker]->Set_Mass(masses[mass_indices[k]]);
+			column_log_likelihoods[k] = copies.detectors[worker]->Log_Likelihoods_Fixed_Mass(*copies.particles[worker], *copies.distributions[worker], column_couplings, coupling_min, coupling_max, column_maxima[k]);
+		});
+		for(unsigned int k = 0; k < mass_indices.size(); k++)
+		{
+			for(unsigned int l = 0; l < column_log_likelihoods[k].size(); l++)
+				log_likelihoods[{mass_indices[k], columns[mass_indices[k]][l]}] = column_log_likelihoods[k][l];
+			log_likelihood_max = std::max(log_likelihood_max, column_maxima[k]);
+		}
+	};
+
+	// Critical values of the chi-squared distribution with two degrees of freedom
+	std::vector<double> delta_chi_squares;
+	for(auto& certainty_level : certainty_levels)
+		delta_chi_squares.push_back(-2.0 * log(1.0 - certainty_level));
+	auto delta_chi_square = [&log_likelihoods, &log_likelihood_max](unsigned int i, unsigned int j) {
+		return 2.0 * (log_likelihood_max - log_likelihoods[{i, j}]);
+	};
+
+	// 1. Initial grid
+	std::vector<std::pair<unsigned int, unsigned int>> cells;
+	std::set<std::pair<unsigned int, unsigned int>> points;
+	for(unsigned int i = 0; i + step < masses.size(); i += step)
+		for(unsigned int j = 0; j + step < couplings.size(); j += step)
+		{
+			cells.push_back({i, j});
+			for(auto& corner : std::vector<std::pair<unsigned int, unsigned int>> {{i, j}, {i + step, j}, {i, j + step}, {i + step, j + step}})
+				points.insert(corner);
+		}
+	evaluate(points);
+
+	// 2. Refine the cells crossed by a contour and their neighbours, such that contours close to a cell's edge are not missed.
+	for(unsigned int size = step; size > 1; size /= 2)
+	{
+		std::set<std::pair<unsigned int, unsigned int>> refined_cells;
+		for(auto& cell : cells)
+		{
+			std::vector<double> corners	= {delta_chi_square(cell.first, cell.second), delta_chi_square(cell.first + size, cell.second), delta_chi_square(cell.first, cell.second + size), delta_chi_square(cell.first + size, cell.second + size)};
+			double corners_min			= *std::min_element(corners.begin(), corners.end());
+			double corners_max			= *std::max_element(corners.begin(), corners.end());
+			bool crossed				= false;
+			for(auto& level : delta_chi_squares)
+				crossed = crossed || (corners_min < level && corners_max >= level);
+			if(!crossed)
+				continue;
+			for(int di = -1; di <= 1; di++)
+				for(int dj = -1; dj <= 1; dj++)
+				{
+					int i = cell.first + di * static_cast<int>(size);
+					int j = cell.second + dj * static_cast<int>(size);
+					if(i >= 0 && j >= 0 && i + size < masses.size() && j + size < couplings.size())
+						refined_cells.insert({i, j});
+				}
+		}
+		cells.clear();
+		points.clear();
+		unsigned int half = size / 2;
+		for(auto& cell : refined_cells)
+			for(unsigned int di = 0; di <= size; di += half)
+				for(unsigned int dj = 0; dj <= size; dj += half)
+				{
+					points.insert({cell.first + di, cell.second + dj});
+					if(di < size && dj < size)
+						cells.push_back({cell.first + di, cell.second + dj});
+				}
+		evaluate(points);
+	}
+
+	// 3. Marching squares on the finest cells, where the crossing points on the cell edges are interpolated linearly in the logarithms of mass and coupling.
+	// An edge starting at the grid point (i, j) along the mass (direction 0) or coupling axis (direction 1) is labeled by the key 2 * (i * couplings + j) + direction.
+	std::vector<Likelihood_Contour> contours;
+	auto edge_key = [&couplings](unsigned int i, unsigned int j, unsigned int direction) {
+		return 2 * (static_cast<unsigned long int>(i) * couplings.size() + j) + direction;
+	};
+	for(unsigned int l = 0; l < delta_chi_squares.size(); l++)
+	{
+		double level = delta_chi_squares[l];
+		std::map<unsigned long int, std::vector<double>> crossing_points;
+		std::map<unsigned long int, std::vector<unsigned long int>> segments;
+		for(auto& cell : cells)
 		{
-			DM.Set_Interaction_Parameter(coupling, targets);
-			log_likelihoods.push_back({mass, coupling, Log_Likelihood(DM, DM_distr)});
+			unsigned int i = cell.first;
+			unsigned int j = cell.second;
+			// Corners in counter-clockwise order and the edges between them
+			std::vector<std::pair<unsigned int, unsigned int>> corners = {{i, j}, {i + 1, j}, {i + 1, j + 1}, {i, j + 1}};
+			std::vector<unsigned long int> edges					   = {edge_key(i, j, 0), edge_key(i + 1, j, 1), edge_key(i, j + 1, 0), edge_key(i, j, 1)};
+			std::vector<double> values;
+			for(auto& corner : corners)
+				values.push_back(delta_chi_square(corner.first, corner.second));
+			std::vector<unsigned int> crossed_edges;
+			for(unsigned int e = 0; e < 4; e++)
+			{
+				auto& start	= corners[e];
+				auto& end	= corners[(e + 1) % 4];
+				double v_1	= values[e];
+				double v_2	= values[(e + 1) % 4];
+				if((v_1 < level) == (v_2 < level))
+					continue;
+				crossed_edges.push_back(e);
+				if(crossing_points.count(edges[e]) == 0)
+				{
+					double t				  = std::isfinite(v_1) && std::isfinite(v_2) ? (level - v_1) / (v_2 - v_1) : (std::isfinite(v_1) ? 0.0 : 1.0);
+					double log10_mass		  = log10(masses[start.first]) + t * (log10(masses[end.first]) - log10(masses[start.first]));
+					double log10_coupling	  = log10(couplings[start.second]) + t * (log10(couplings[end.second]) - log10(couplings[start.second]));
+					crossing_points[edges[e]] = {pow(10.0, log10_mass), pow(10.0, log10_coupling)};
+				}
+			}
+			std::vector<std::pair<unsigned int, unsigned int>> cell_segments;
+			if(crossed_edges.size() == 2)
+				cell_segments.push_back({crossed_edges[0], crossed_edges[1]});
+			else if(crossed_edges.size() == 4)
+			{
+				// Saddle point: The average of the corners decides if the diagonal of the corners 0 and 2 is connected.
+				bool center_inside		= (values[0] + values[1] + values[2] + values[3]) / 4.0 < level;
+				bool diagonal_connected	= (values[0] < level) == center_inside;
+				if(diagonal_connected)
+					cell_segments = {{0, 1}, {2, 3}};
+				else
+					cell_segments = {{3, 0}, {1, 2}};
+			}
+			for(auto& segment : cell_segments)
+			{
+				segments[edges[segment.first]].push_back(edges[segment.second]);
+				segments[edges[segment.second]].push_back(edges[segment.first]);
+			}
 		}
+
+		// Join the segments to polylines, first the open ones, starting at the edges with a single segment, then the closed ones.
+		std::set<unsigned long int> visited;
+		for(unsigned int pass = 0; pass < 2; pass++)
+			for(auto& edge : segments)
+			{
+				if(visited.count(edge.first) > 0 || (pass == 0 && edge.second.size() != 1))
+					continue;
+				Likelihood_Contour contour;
+				contour.certainty_level	  = certainty_levels[l];
+				contour.delta_chi_square  = level;
+				unsigned long int current = edge.first;
+				while(true)
+				{
+					visited.insert(current);
+					contour.points.push_back(crossing_points[current]);
+					auto next = std::find_if(segments[current].begin(), segments[current].end(), [&visited](unsigned long int key) { return visited.count(key) == 0; });
+					if(next == segments[current].end())
+						break;
+					current = *next;
+				}
+				contour.closed = (pass == 1);
+				if(contour.closed)
+					contour.points.push_back(contour.points.front());
+				contours.push_back(contour);
+			}
 	}
+
 	DM.Set_Mass(m_original);
 	DM.Set_Interaction_Parameter(coupling_original, targets);
-	return log_likelihoods;
+	return contours;
 }
 
 double DM_Detector::P_Value(DM_Particle& DM, DM_Distribution& DM_distr)
 {
-	double p_value = 1.0;
-	if(statistical_analysis == "Poisson")
+	double p_value		   = 1.0;
+	bool poisson		   = (statistical_analysis == "Poisson" || statistical_analysis == "Binned Poisson");
+	std::string statistics = Poisson_Statistics();
+	if(using_CLs && (poisson || statistical_analysis == "Unbinned Likelihood"))
+		p_value = P_Value_CLs(DM, DM_distr);
+	else if(poisson && statistics == "Likelihood Ratio")
+		p_value = P_Value_Likelihood_Ratio(DM, DM_distr);
+	else if(statistical_analysis == "Poisson")
 	{
 		double DM_expectation_value;
 		if(using_fiducial_values)
-		{
-			double coupling = DM.Get_Interaction_Parameter(targets);
-
-			int rescaling_power = 2;
-			if(DM.Interaction_Parameter_Is_Cross_Section())
-				rescaling_power = 1;
-
-			DM_expectation_value = pow(coupling / fiducial_coupling, rescaling_power) * fiducial_signals;
-		}
+			DM_expectation_value = Fiducial_Rescaling_Factor(DM) * fiducial_signals;
 		else
 			DM_expectation_value = DM_Signals_Total(DM, DM_distr);
-		p_value = libphysica::CDF_Poisson(DM_expectation_value + expected_background, observed_events);
+		double background = expected_background;
+		if(profiling_background)
+			background *= Background_Normalizations({DM_expectation_value}, Observed_Events(), {expected_background})[0];
+		if(statistics == "Feldman-Cousins")
+			p_value = P_Value_Feldman_Cousins(observed_events, DM_expectation_value, background);
+		else
+			p_value = libphysica::CDF_Poisson(DM_expectation_value + background, observed_events);
 	}
 	else if(statistical_analysis == "Binned Poisson")
 	{
 		std::vector<double> expectation_values;
 		if(using_fiducial_values)
 		{
-			double coupling		= DM.Get_Interaction_Parameter(targets);
-			int rescaling_power = 2;
-			if(DM.Interaction_Parameter_Is_Cross_Section())
-				rescaling_power = 1;
+			double rescaling_factor = Fiducial_Rescaling_Factor(DM);
 			for(unsigned int i = 0; i < fiducial_spectrum.size(); i++)
-				expectation_values.push_back(pow(coupling / fiducial_coupling, rescaling_power) * fiducial_spectrum[i]);
+				expectation_values.push_back(rescaling_factor * fiducial_spectrum[i]);
 		}
 		else
 			expectation_values = DM_Signals_Binned(DM, DM_distr);
+		std::vector<double> backgrounds = bin_expected_background;
+		if(profiling_background)
+		{
+			std::vector<double> normalizations = Background_Normalizations(expectation_values, Observed_Events(), backgrounds);
+			for(unsigned int i = 0; i < number_of_bins; i++)
+				backgrounds[i] *= normalizations[i];
+		}
 		std::vector<double> p_values(number_of_bins, 0.0);
 		for(unsigned int i = 0; i < number_of_bins; i++)
 		{
-			double expectation_value = expectation_values[i] + bin_expected_background[i];
-			p_values[i]				 = libphysica::CDF_Poisson(expectation_value, bin_observed_events[i]);
+			if(statistics == "Feldman-Cousins")
+				p_values[i] = P_Value_Feldman_Cousins(bin_observed_events[i], expectation_values[i], backgrounds[i]);
+			else
+				p_values[i] = libphysica::CDF_Poisson(expectation_values[i] + backgrounds[i], bin_observed_events[i]);
 		}
 		p_value = *std::min_element(p_values.begin(), p_values.end());
 	}
@@ -118,6 +484,14 @@ double DM_Detector::P_Value(DM_Particle& DM, DM_Distribution& DM_distr)
 	{
 		p_value = P_Value_Maximum_Gap(DM, DM_distr);
 	}
+	else if(statistical_analysis == "Optimum Interval")
+	{
+		p_value = P_Value_Optimum_Interval(DM, DM_distr);
+	}
+	else if(statistical_analysis == "Unbinned Likelihood")
+	{
+		p_value = P_Value_Unbinned(DM, DM_distr);
+	}
 	else
 	{
 		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector_Nucleus::P_Value(): Analysis " << statistical_analysis << " not recognized." << std::endl;
@@ -148,11 +522,20 @@ void DM_Detector::Set_Observed_Events(unsigned long int n)
 	}
 }
 
+std::vector<double> DM_Detector::Observed_Events() const
+{
+	if(statistical_analysis == "Binned Poisson")
+		return std::vector<double>(bin_observed_events.begin(), bin_observed_events.end());
+	else
+		return {1.0 * observed_events};
+}
+
 void DM_Detector::Set_Expected_Background(double B)
 {
-	if(statistical_analysis != "Poisson")
+	// For Yellin's methods, the background is not part of the analysis, but it is used for pseudo-experiments.
+	if(statistical_analysis != "Poisson" && statistical_analysis != "Maximum Gap" && statistical_analysis != "Optimum Interval" && statistical_analysis != "Unbinned Likelihood")
 	{
-		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::Set_Expected_Background(double): Statistical analysis is " << statistical_analysis << " not 'Poisson'." << std::endl;
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::Set_Expected_Background(double): Statistical analysis is " << statistical_analysis << " not 'Poisson', 'Maximum Gap', 'Optimum Interval', or 'Unbinned Likelihood'." << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
 	else
@@ -161,6 +544,356 @@ void DM_Detector::Set_Expected_Background(double B)
 	}
 }
 
+void DM_Detector::Use_Background_Profiling(bool use_background_profiling, double relative_uncertainty, bool per_bin)
+{
+	if(use_background_profiling && relative_uncertainty <= 0.0)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::Use_Background_Profiling(): The relative uncertainty of the background normalization has to be positive, not " << relative_uncertainty << "." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	profiling_background				 = use_background_profiling;
+	profiling_background_per_bin		 = per_bin;
+	background_normalization_uncertainty = relative_uncertainty;
+	Check_Statistical_Methods("Use_Background_Profiling");
+}
+
+std::vector<double> DM_Detector::Background_Normalizations(const std::vector<double>& signals, const std::vector<double>& events, const std::vector<double>& backgrounds) const
+{
+	// Maximize ln L = sum_i ln Poisson(n_i | s_i + theta_i b_i) - sum_i (theta_i - 1)^2 / 2 sigma^2 w.r.t. the normalizations theta_i >= 0.
+	double sigma_2 = background_normalization_uncertainty * background_normalization_uncertainty;
+	if(profiling_background_per_bin || signals.size() == 1)
+	{
+		// Every bin is independent, and the stationary condition is a quadratic equation for theta.
+		std::vector<double> normalizations(signals.size(), 1.0);
+		for(unsigned int i = 0; i < signals.size(); i++)
+		{
+			double s = signals[i];
+			double b = backgrounds[i];
+			if(b <= 0.0)
+				continue;
+			double p		  = sigma_2 * b * b + s - b;
+			double q		  = sigma_2 * b * (events[i] - s) + s;
+			normalizations[i] = std::max(0.0, (-p + sqrt(p * p + 4.0 * b * q)) / 2.0 / b);
+		}
+		return normalizations;
+	}
+	else
+	{
+		// One global normalization, which is found by Newton's method. The derivative of ln L is convex and decreasing in theta, so the iteration converges from any theta > 0.
+		double theta = 1.0;
+		for(unsigned int iteration = 0; iteration < 100; iteration++)
+		{
+			double derivative		 = -(theta - 1.0) / sigma_2;
+			double second_derivative = -1.0 / sigma_2;
+			for(unsigned int i = 0; i < signals.size(); i++)
+			{
+				double expectation_value = signals[i] + theta * backgrounds[i];
+				if(expectation_value <= 0.0)
+					continue;
+				derivative += events[i] * backgrounds[i] / expectation_value - backgrounds[i];
+				second_derivative -= events[i] * backgrounds[i] * backgrounds[i] / expectation_value / expectation_value;
+			}
+			double theta_new = theta - derivative / second_derivative;
+			if(theta_new <= 0.0)
+				theta_new = theta / 2.0;
+			if(std::fabs(theta_new - theta) < 1.0e-10 * theta)
+			{
+				theta = theta_new;
+				break;
+			}
+			theta = theta_new;
+		}
+		return std::vector<double>(signals.size(), theta);
+	}
+}
+
+double DM_Detector::Log_Background_Constraint(const std::vector<double>& normalizations) const
+{
+	double sigma_2		  = background_normalization_uncertainty * background_normalization_uncertainty;
+	double log_constraint = 0.0;
+	for(auto& normalization : normalizations)
+	{
+		log_constraint -= (normalization - 1.0) * (normalization - 1.0) / 2.0 / sigma_2;
+		if(!profiling_background_per_bin)
+			break;
+	}
+	return log_constraint;
+}
+
+void DM_Detector::Use_Feldman_Cousins(bool use_feldman_cousins)
+{
+	using_feldman_cousins = use_feldman_cousins;
+	Check_Statistical_Methods("Use_Feldman_Cousins");
+}
+
+void DM_Detector::Use_Bayesian_Limits(bool use_bayesian_limits, std::string prior, double minimum_interaction_parameter)
+{
+	if(prior != "Flat" && prior != "Log")
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::Use_Bayesian_Limits(): Prior " << prior << " not recognized (options are 'Flat' and 'Log')." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	else if(prior == "Log" && minimum_interaction_parameter <= 0.0)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::Use_Bayesian_Limits(): The log prior requires a positive minimum interaction parameter." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	using_bayesian_limits				   = use_bayesian_limits;
+	bayesian_prior						   = prior;
+	bayesian_minimum_interaction_parameter = minimum_interaction_parameter;
+	Check_Statistical_Methods("Use_Bayesian_Limits");
+}
+
+std::string DM_Detector::Poisson_Statistics() const
+{
+	if(using_feldman_cousins)
+		return "Feldman-Cousins";
+	else if(using_bayesian_limits)
+		return "Bayesian";
+	else if(using_CLs)
+		return "CLs";
+	else if(using_likelihood_ratio)
+		return "Likelihood Ratio";
+	else if(profiling_background)
+		return "Profiled Poisson";
+	else
+		return "Poisson";
+}
+
+void DM_Detector::Check_Statistical_Methods(const std::string& function) const
+{
+	// Only the asymptotic likelihood ratio supports a profiled background.
+	int methods = using_feldman_cousins + using_bayesian_limits + using_CLs + using_likelihood_ratio;
+	if(methods > 1 || (profiling_background && methods > using_likelihood_ratio))
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::" << function << "(): Feldman-Cousins, Bayesian limits, CLs, and the likelihood ratio exclude each other, and only the likelihood ratio supports a profiled background. Disable the other method first." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+}
+
+// Asymptotic likelihood ratio test
+void DM_Detector::Use_Likelihood_Ratio(bool use_likelihood_ratio)
+{
+	using_likelihood_ratio = use_likelihood_ratio;
+	Check_Statistical_Methods("Use_Likelihood_Ratio");
+}
+
+double DM_Detector::Log_Likelihood_Poisson_Signal_Strength(double r, const std::vector<double>& signals, const std::vector<double>& events) const
+{
+	std::vector<double> backgrounds = (statistical_analysis == "Binned Poisson") ? bin_expected_background : std::vector<double>({expected_background});
+	double log_constraint			= 0.0;
+	if(profiling_background)
+	{
+		std::vector<double> rescaled_signals;
+		for(auto& s : signals)
+			rescaled_signals.push_back(r * s);
+		std::vector<double> normalizations = Background_Normalizations(rescaled_signals, events, backgrounds);
+		for(unsigned int i = 0; i < backgrounds.size(); i++)
+			backgrounds[i] *= normalizations[i];
+		log_constraint = Log_Background_Constraint(normalizations);
+	}
+	// The background term only cancels in the likelihood ratio if the background is fixed.
+	double total_signals	 = std::accumulate(signals.begin(), signals.end(), 0.0);
+	double total_backgrounds = std::accumulate(backgrounds.begin(), backgrounds.end(), 0.0);
+	return Log_Likelihood_Signal_Strength(r, total_signals, events, signals, backgrounds) - total_backgrounds + log_constraint;
+}
+
+double DM_Detector::Best_Fit_Poisson_Signal_Strength(const std::vector<double>& signals, const std::vector<double>& events) const
+{
+	double total_signals = std::accumulate(signals.begin(), signals.end(), 0.0);
+	double total_events	 = std::accumulate(events.begin(), events.end(), 0.0);
+	if(total_signals <= 0.0 || total_events == 0.0)
+		return 0.0;
+	if(!profiling_background)
+	{
+		std::vector<double> backgrounds = (statistical_analysis == "Binned Poisson") ? bin_expected_background : std::vector<double>({expected_background});
+		return Best_Fit_Signal_Strength(total_signals, events, signals, backgrounds);
+	}
+	// The profile likelihood is concave in r, and d ln L / dr < -S + N / r, such that the best fit lies below N / S.
+	std::function<double(double)> log_likelihood = [this, &signals, &events](double r) {
+		return Log_Likelihood_Poisson_Signal_Strength(r, signals, events);
+	};
+	double r_max = total_events / total_signals;
+	return Golden_Section_Maximum(log_likelihood, 0.0, r_max, 1.0e-8 * r_max);
+}
+
+double DM_Detector::P_Value_Likelihood_Ratio(DM_Particle& DM, DM_Distribution& DM_distr)
+{
+	// One-sided test statistic q of the signal strength, with p = 1 - Phi(sqrt(q)). With fiducial values, the signal strength is the rescaling factor of the fiducial signals.
+	std::vector<double> signals;
+	double r = 1.0;
+	if(using_fiducial_values)
+	{
+		signals = (statistical_analysis == "Binned Poisson") ? fiducial_spectrum : std::vector<double>({fiducial_signals});
+		r		= Fiducial_Rescaling_Factor(DM);
+	}
+	else
+		signals = (statistical_analysis == "Binned Poisson") ? DM_Signals_Binned(DM, DM_distr) : std::vector<double>({DM_Signals_Total(DM, DM_distr)});
+	std::vector<double> events = Observed_Events();
+	double best_fit			   = Best_Fit_Poisson_Signal_Strength(signals, events);
+	if(best_fit >= r)
+		return 0.5;
+	double q = std::max(0.0, 2.0 * (Log_Likelihood_Poisson_Signal_Strength(best_fit, signals, events) - Log_Likelihood_Poisson_Signal_Strength(r, signals, events)));
+	return std::erfc(sqrt(q / 2.0)) / 2.0;
+}
+
+// Re-scaling r above the best fit where the one-sided test statistic 2 * (ln L(r_best) - ln L(r)) equals z^2 with the z-score of the certainty level
+static double Likelihood_Ratio_Rescaling(const std::function<double(double)>& log_likelihood, double best_fit, double signals, double certainty)
+{
+	double log_likelihood_best_fit	   = log_likelihood(best_fit);
+	double z						   = sqrt(2.0) * boost::math::erf_inv(2.0 * certainty - 1.0);
+	std::function<double(double)> func = [&log_likelihood, log_likelihood_best_fit, z](double r) {
+		return 2.0 * (log_likelihood_best_fit - log_likelihood(r)) - z * z;
+	};
+	double r_max = std::max(2.0 * best_fit, 1.0 / signals);
+	while(func(r_max) < 0.0)
+		r_max *= 2.0;
+	return libphysica::Find_Root(func, best_fit, r_max, 1.0e-6 * r_max);
+}
+
+double DM_Detector::Fiducial_Upper_Limit_Likelihood_Ratio(const DM_Particle& DM, const std::vector<double>& events, double certainty) const
+{
+	std::vector<double> signals = (statistical_analysis == "Binned Poisson") ? fiducial_spectrum : std::vector<double>({fiducial_signals});
+	double total_signals		= std::accumulate(signals.begin(), signals.end(), 0.0);
+	if(total_signals <= 0.0)
+		return -1.0;
+	std::function<double(double)> log_likelihood = [this, &signals, &events](double r) {
+		return Log_Likelihood_Poisson_Signal_Strength(r, signals, events);
+	};
+	double rescaling_factor = Likelihood_Ratio_Rescaling(log_likelihood, Best_Fit_Poisson_Signal_Strength(signals, events), total_signals, certainty);
+	return Rescaled_Fiducial_Coupling(DM, rescaling_factor);
+}
+
+// CLs from pseudo-experiments
+void DM_Detector::Use_CLs(bool use_CLs, double precision, unsigned long int maximum_toys, unsigned long int seed, unsigned int threads)
+{
+	if(precision <= 0.0 || maximum_toys == 0)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::Use_CLs(): The precision (" << precision << ") and the maximum number of toys (" << maximum_toys << ") have to be positive." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	using_CLs		 = use_CLs;
+	CLs_precision	 = precision;
+	CLs_maximum_toys = maximum_toys;
+	CLs_seed		 = seed;
+	CLs_threads		 = threads;
+	Check_Statistical_Methods("Use_CLs");
+}
+
+// Toys are generated in batches, and every toy has its own random seed, such that the result does not depend on the number of threads.
+const unsigned int CLs_batch_size = 1000;
+
+double DM_Detector::P_Value_CLs(DM_Particle& DM, DM_Distribution& DM_distr)
+{
+	// The toys only re-scale the fiducial signals.
+	bool fiducial_values_set = using_fiducial_values;
+	if(!fiducial_values_set)
+		Set_Fiducial_Values(DM, DM_distr);
+	double rescaling_factor = Fiducial_Rescaling_Factor(DM);
+
+	// 1. Observed data as terms of the likelihood of the signal strength, i.e. bins or events. The energies of signal events are sampled from the fiducial spectrum.
+	std::vector<double> weights, signal_terms, background_terms;
+	if(statistical_analysis == "Unbinned Likelihood")
+	{
+		signal_terms	 = fiducial_spectrum;
+		background_terms = std::vector<double>(signal_terms.size(), Unbinned_Background_Spectrum());
+		weights			 = std::vector<double>(signal_terms.size(), 1.0);
+	}
+	else if(statistical_analysis == "Binned Poisson")
+	{
+		signal_terms	 = fiducial_spectrum;
+		background_terms = bin_expected_background;
+		weights			 = std::vector<double>(bin_observed_events.begin(), bin_observed_events.end());
+	}
+	else
+	{
+		signal_terms	 = {fiducial_signals};
+		background_terms = {expected_background};
+		weights			 = {1.0 * observed_events};
+	}
+	double signals	  = (statistical_analysis == "Unbinned Likelihood") ? fiducial_signals : std::accumulate(signal_terms.begin(), signal_terms.end(), 0.0);
+	double q_observed = Test_Statistic_Signal_Strength(rescaling_factor, signals, weights, signal_terms, background_terms);
+
+	// Without toys, CLs = 1 if the data prefer a larger signal, and CLs = 0 if the signal is excluded far beyond the reach of any number of toys (asymptotically p < 1e-20).
+	double CLs = 1.0;
+	if(q_observed <= 0.0 || q_observed > 100.0)
+	{
+		if(!fiducial_values_set)
+			Reset_Fiducial_Values();
+		return (q_observed <= 0.0) ? 1.0 : 0.0;
+	}
+
+	// 2. Test statistic of a toy generated with the signal strength r_toy.
+	std::function<double(unsigned long int, double)> toy_test_statistic = [this, &weights, &signal_terms, &background_terms, signals, rescaling_factor](unsigned long int toy_seed, double r_toy) {
+		std::mt19937_64 generator(toy_seed);
+		std::vector<double> toy_weights, toy_signal_terms, toy_background_terms;
+		if(statistical_analysis == "Unbinned Likelihood")
+		{
+			std::vector<double> events;
+			std::uniform_real_distribution<double> uniform_distribution(0.0, 1.0);
+			if(r_toy * signals > 0.0)
+			{
+				std::poisson_distribution<unsigned long int> poisson_distribution(r_toy * signals);
+				for(unsigned long int i = poisson_distribution(generator); i > 0; i--)
+					events.push_back(fiducial_energy_spectrum.Inverse_Cumulative_Signals(uniform_distribution(generator) * fiducial_signals));
+			}
+			if(expected_background > 0.0)
+			{
+				std::poisson_distribution<unsigned long int> poisson_distribution(expected_background);
+				for(unsigned long int i = poisson_distribution(generator); i > 0; i--)
+					events.push_back(energy_threshold + uniform_distribution(generator) * (energy_max - energy_threshold));
+			}
+			toy_signal_terms	 = Unbinned_Event_Spectrum(fiducial_energy_spectrum, events);
+			toy_background_terms = std::vector<double>(events.size(), Unbinned_Background_Spectrum());
+			toy_weights			 = std::vector<double>(events.size(), 1.0);
+		}
+		else
+		{
+			toy_signal_terms	 = signal_terms;
+			toy_background_terms = background_terms;
+			for(unsigned int k = 0; k < signal_terms.size(); k++)
+			{
+				double expectation_value = r_toy * signal_terms[k] + background_terms[k];
+				std::poisson_distribution<unsigned long int> poisson_distribution((expectation_value > 0.0) ? expectation_value : 1.0);
+				toy_weights.push_back((expectation_value > 0.0) ? poisson_distribution(generator) : 0.0);
+			}
+		}
+		return Test_Statistic_Signal_Strength(rescaling_factor, signals, toy_weights, toy_signal_terms, toy_background_terms);
+	};
+
+	// 3. CLs = P(q >= q_obs | s+b) / P(q >= q_obs | b), with toys generated in batches until the binomial uncertainty of CLs is below the precision.
+	unsigned long int toys = 0, signal_counts = 0, background_counts = 0;
+	while(toys < CLs_maximum_toys)
+	{
+		unsigned long int batch = std::min(static_cast<unsigned long int>(CLs_batch_size), CLs_maximum_toys - toys);
+		std::vector<int> signal_exceeds(batch, 0), background_exceeds(batch, 0);
+		Parallel_For(batch, CLs_threads, [this, &toy_test_statistic, &signal_exceeds, &background_exceeds, toys, rescaling_factor, q_observed](unsigned int i, unsigned int worker) {
+			unsigned long int toy = toys + i;
+			signal_exceeds[i]	  = toy_test_statistic(CLs_seed + 2 * toy, rescaling_factor) >= q_observed;
+			background_exceeds[i] = toy_test_statistic(CLs_seed + 2 * toy + 1, 0.0) >= q_observed;
+		});
+		toys += batch;
+		signal_counts += std::accumulate(signal_exceeds.begin(), signal_exceeds.end(), 0);
+		background_counts += std::accumulate(background_exceeds.begin(), background_exceeds.end(), 0);
+
+		double p_signal		= 1.0 * signal_counts / toys;
+		double p_background	= 1.0 * background_counts / toys;
+		if(background_counts == 0)
+		{
+			CLs = (signal_counts > 0) ? 1.0 : 0.0;
+			break;
+		}
+		CLs				= std::min(1.0, p_signal / p_background);
+		double variance	= (p_signal * (1.0 - p_signal) + CLs * CLs * p_background * (1.0 - p_background)) / toys / p_background / p_background;
+		if(sqrt(variance) <= CLs_precision)
+			break;
+	}
+
+	if(!fiducial_values_set)
+		Reset_Fiducial_Values();
+	return CLs;
+}
+
 // (b) Binned Poisson statistics
 void DM_Detector::Initialize_Binned_Poisson(unsigned bins)
 {
@@ -246,58 +979,163 @@ void DM_Detector::Use_Maximum_Gap(std::vector<double> energies)
 	energy_max		 = maximum_gap_energy_data.back();
 }
 
-double CDF_Maximum_Gap(double x, double mu)
+std::vector<double> DM_Detector::Maximum_Gap_Signals(const Tabulated_Spectrum& spectrum) const
 {
-	if(x == mu)
-		return 1.0 - exp(-mu);
-	else
+	// Determine the expected signals in all gaps.
+	std::vector<double> gaps;
+	for(unsigned int i = 0; i < (maximum_gap_energy_data.size() - 1); i++)
 	{
-		int m	   = mu / x;
-		double sum = 0.0;
-		for(int k = 0; k <= m; k++)
-		{
-			double term = pow(k * x - mu, k) / libphysica::Factorial(k) * exp(-k * x) * (1.0 + k / (mu - k * x));
-			sum += term;
-			if(fabs(term) < 1e-20)
-				break;
-		}
-		return sum;
+		double E1  = maximum_gap_energy_data[i];
+		double E2  = maximum_gap_energy_data[i + 1];
+		double gap = spectrum.Signals(E1, E2);
+		gaps.push_back(gap);
 	}
+	return gaps;
 }
 
-double DM_Detector::P_Value_Maximum_Gap(DM_Particle& DM, DM_Distribution& DM_distr)
+std::vector<double> DM_Detector::Gap_Signals(DM_Particle& DM, DM_Distribution& DM_distr)
 {
-	// Interpolate the spectrum
-	unsigned int interpolation_points = 400;
-	std::vector<double> energies;
-	double maximum_energy_deposit = Maximum_Energy_Deposit(DM, DM_distr);
-	if(maximum_energy_deposit < energy_max)
+	std::vector<double> gaps;
+	if(using_fiducial_values)
 	{
-		energies = libphysica::Linear_Space(energy_threshold, maximum_energy_deposit, interpolation_points);
-		energies.push_back(energy_max);
+		double rescaling_factor = Fiducial_Rescaling_Factor(DM);
+		for(unsigned int i = 0; i < fiducial_gaps.size(); i++)
+			gaps.push_back(rescaling_factor * fiducial_gaps[i]);
 	}
 	else
-		energies = libphysica::Linear_Space(energy_threshold, energy_max, interpolation_points);
-	std::vector<double> spectrum_values;
-	for(auto& energy : energies)
-		spectrum_values.push_back(exposure * dRdE(energy, DM, DM_distr));
-	libphysica::Interpolation spectrum(energies, spectrum_values);
+		gaps = Maximum_Gap_Signals(DM_Spectrum(DM, DM_distr));
+	return gaps;
+}
 
-	// Determine all gaps and find the maximum.
-	std::vector<double> gaps;
-	for(unsigned int i = 0; i < (maximum_gap_energy_data.size() - 1); i++)
+double DM_Detector::P_Value_Maximum_Gap(DM_Particle& DM, DM_Distribution& DM_distr)
+{
+	return obscura::P_Value_Maximum_Gap(Gap_Signals(DM, DM_distr));
+}
+
+// (d) Optimum interval a'la Yellin
+void DM_Detector::Use_Optimum_Interval(std::vector<double> energies)
+{
+	Use_Maximum_Gap(energies);
+	statistical_analysis = "Optimum Interval";
+}
+
+double DM_Detector::P_Value_Optimum_Interval(DM_Particle& DM, DM_Distribution& DM_distr)
+{
+	return obscura::P_Value_Optimum_Interval(Gap_Signals(DM, DM_distr));
+}
+
+// (e) Unbinned extended likelihood
+void DM_Detector::Use_Unbinned_Likelihood(std::vector<double> energies)
+{
+	Use_Maximum_Gap(energies);
+	statistical_analysis = "Unbinned Likelihood";
+}
+
+double DM_Detector::Unbinned_Signals(const Tabulated_Spectrum& spectrum, std::vector<double>& event_spectrum) const
+{
+	event_spectrum = Unbinned_Event_Spectrum(spectrum, Unbinned_Events());
+	return spectrum.Signals(energy_threshold, energy_max);
+}
+
+std::vector<double> DM_Detector::Unbinned_Events() const
+{
+	return std::vector<double>(maximum_gap_energy_data.begin() + 1, maximum_gap_energy_data.end() - 1);
+}
+
+std::vector<double> DM_Detector::Unbinned_Event_Spectrum(const Tabulated_Spectrum& spectrum, const std::vector<double>& events) const
+{
+	std::vector<double> event_spectrum;
+	for(auto& event : events)
+		event_spectrum.push_back(spectrum(event));
+	return event_spectrum;
+}
+
+double DM_Detector::Unbinned_Background_Spectrum() const
+{
+	return expected_background / (energy_max - energy_threshold);
+}
+
+double DM_Detector::Log_Likelihood_Unbinned(const std::vector<double>& event_spectrum, double signals, double rescaling_factor) const
+{
+	double log_likelihood = -rescaling_factor * signals - expected_background;
+	for(auto& s : event_spectrum)
+		log_likelihood += log(rescaling_factor * s + Unbinned_Background_Spectrum());
+	return log_likelihood;
+}
+
+double DM_Detector::P_Value_Unbinned(DM_Particle& DM, DM_Distribution& DM_distr)
+{
+	// One-sided test statistic q of the signal strength r = 1, with p = 1 - Phi(sqrt(q)).
+	std::vector<double> event_spectrum = fiducial_spectrum;
+	double signals					   = fiducial_signals;
+	if(using_fiducial_values)
 	{
-		double E1  = maximum_gap_energy_data[i];
-		double E2  = maximum_gap_energy_data[i + 1];
-		double gap = spectrum.Integrate(E1, E2);
-		gaps.push_back(gap);
+		double rescaling_factor = Fiducial_Rescaling_Factor(DM);
+		for(auto& s : event_spectrum)
+			s *= rescaling_factor;
+		signals *= rescaling_factor;
 	}
+	else
+		signals = Unbinned_Signals(DM_Spectrum(DM, DM_distr), event_spectrum);
+	std::vector<double> weights(event_spectrum.size(), 1.0);
+	std::vector<double> backgrounds(event_spectrum.size(), Unbinned_Background_Spectrum());
+	double q = Test_Statistic_Signal_Strength(1.0, signals, weights, event_spectrum, backgrounds);
+	return std::erfc(sqrt(q / 2.0)) / 2.0;
+}
 
-	double max_gap = *std::max_element(gaps.begin(), gaps.end());
+double DM_Detector::Fiducial_Upper_Limit_Unbinned(const DM_Particle& DM, const std::vector<double>& event_spectrum, double certainty) const
+{
+	if(fiducial_signals <= 0.0)
+		return -1.0;
+	// Find the rescaling of the fiducial signals above the best fit such that q = z^2 with the one-sided z-score of the certainty level.
+	std::vector<double> weights(event_spectrum.size(), 1.0);
+	std::vector<double> backgrounds(event_spectrum.size(), Unbinned_Background_Spectrum());
+	std::function<double(double)> log_likelihood = [this, &weights, &event_spectrum, &backgrounds](double r) {
+		return Log_Likelihood_Signal_Strength(r, fiducial_signals, weights, event_spectrum, backgrounds);
+	};
+	double best_fit			= Best_Fit_Signal_Strength(fiducial_signals, weights, event_spectrum, backgrounds);
+	double rescaling_factor = Likelihood_Ratio_Rescaling(log_likelihood, best_fit, fiducial_signals, certainty);
+	return Rescaled_Fiducial_Coupling(DM, rescaling_factor);
+}
 
-	double N	   = std::accumulate(gaps.begin(), gaps.end(), 0.0);
-	double p_value = 1.0 - CDF_Maximum_Gap(max_gap, N);
-	return p_value;
+DM_Detector* DM_Detector::Clone() const
+{
+	if(typeid(*this) != typeid(DM_Detector))
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::Clone(): The derived class " << typeid(*this).name() << " does not override Clone()." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	return new DM_Detector(*this);
+}
+
+DM_Detector* DM_Detector::Worker_Clone() const
+{
+	DM_Detector* detector = Clone();
+	detector->CLs_threads = 1;
+	return detector;
+}
+
+DM_Detector::Worker_Copies DM_Detector::Copies_For_Workers(DM_Particle& DM, DM_Distribution& DM_distr, unsigned int workers, unsigned int coarsening)
+{
+	Worker_Copies copies;
+	if(workers <= 1 && coarsening == 1)
+	{
+		copies.particles	 = {&DM};
+		copies.distributions = {&DM_distr};
+		copies.detectors	 = {this};
+		return copies;
+	}
+	for(unsigned int worker = 0; worker < std::max(1u, workers); worker++)
+	{
+		copies.particle_copies.push_back(std::unique_ptr<DM_Particle>(DM.Clone()));
+		copies.distribution_copies.push_back(std::unique_ptr<DM_Distribution>(DM_distr.Clone()));
+		copies.detector_copies.push_back(std::unique_ptr<DM_Detector>((workers > 1) ? Worker_Clone() : Clone()));
+		copies.detector_copies.back()->spectrum_coarsening = coarsening;
+		copies.particles.push_back(copies.particle_copies.back().get());
+		copies.distributions.push_back(copies.distribution_copies.back().get());
+		copies.detectors.push_back(copies.detector_copies.back().get());
+	}
+	return copies;
 }
 
 void DM_Detector::Set_Flat_Efficiency(double eff)
@@ -305,12 +1143,47 @@ void DM_Detector::Set_Flat_Efficiency(double eff)
 	flat_efficiency = eff;
 }
 
-std::string DM_Detector::Target_Particles()
+std::string DM_Detector::Target_Particles() const
 {
 	return targets;
 }
 
+std::string DM_Detector::Statistical_Analysis() const
+{
+	return statistical_analysis;
+}
+
 // DM functions
+std::vector<double> DM_Detector::dRdE_Batch(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr)
+{
+	std::vector<double> spectrum;
+	for(auto& energy : energies)
+		spectrum.push_back(dRdE(energy, DM, DM_distr));
+	return spectrum;
+}
+
+Tabulated_Spectrum DM_Detector::DM_Spectrum(const DM_Particle& DM, DM_Distribution& DM_distr)
+{
+	// The kinematic endpoint is evaluated once per mass by Set_Fiducial_Values(). Otherwise, it is unknown and the spectrum is tabulated up to the maximum energy.
+	double kinematic_endpoint = using_fiducial_values ? fiducial_kinematic_endpoint : 0.0;
+	double E_max			  = (kinematic_endpoint > energy_threshold && kinematic_endpoint < energy_max) ? kinematic_endpoint : energy_max;
+
+	unsigned int points			 = Spectrum_Points(400);
+	std::vector<double> energies = (energy_threshold > 0.0) ? libphysica::Log_Space(energy_threshold, E_max, points) : libphysica::Linear_Space(energy_threshold, E_max, points);
+	// The bin edges and the energies of the data are part of the grid, such that bins and gaps are integrated without interpolating across their boundaries.
+	// Above the kinematic endpoint, the spectrum vanishes and is not tabulated.
+	const std::vector<double>& boundaries = using_energy_bins ? bin_energies : maximum_gap_energy_data;
+	for(auto& energy : boundaries)
+		if(energy > energy_threshold && energy < E_max)
+			energies.push_back(energy);
+	std::sort(energies.begin(), energies.end());
+	energies.erase(std::unique(energies.begin(), energies.end(), [](double E_1, double E_2) { return E_2 - E_1 < 1.0e-10 * E_2; }), energies.end());
+	std::vector<double> spectrum = dRdE_Batch(energies, DM, DM_distr);
+	for(auto& value : spectrum)
+		value *= exposure;
+	return Tabulated_Spectrum(energies, spectrum, kinematic_endpoint);
+}
+
 double DM_Detector::DM_Signals_Total(const DM_Particle& DM, DM_Distribution& DM_distr)
 {
 	double N = 0;
@@ -320,16 +1193,7 @@ double DM_Detector::DM_Signals_Total(const DM_Particle& DM, DM_Distribution& DM_
 		N								  = std::accumulate(binned_events.begin(), binned_events.end(), 0.0);
 	}
 	else
-	{
-		std::vector<double> args = libphysica::Log_Space(energy_threshold, energy_max, 200);
-		std::vector<double> values;
-		for(auto& arg : args)
-		{
-			values.push_back(dRdE(arg, DM, DM_distr));
-		}
-		libphysica::Interpolation interpol(args, values);
-		N = exposure * interpol.Integrate(energy_threshold, energy_max);
-	}
+		N = DM_Spectrum(DM, DM_distr).Total_Signals();
 	return N;
 }
 
@@ -354,21 +1218,224 @@ std::vector<double> DM_Detector::DM_Signals_Binned(const DM_Particle& DM, DM_Dis
 	}
 }
 
+unsigned int DM_Detector::Spectrum_Points(unsigned int points) const
+{
+	return std::max(points / spectrum_coarsening, std::min(points, 20u));
+}
+
+// Fiducial values
+void DM_Detector::Set_Fiducial_Values(DM_Particle& DM, DM_Distribution& DM_distr)
+{
+	using_fiducial_values		= true;
+	fiducial_coupling			= DM.Get_Interaction_Parameter(targets);
+	fiducial_kinematic_endpoint = Maximum_Energy_Deposit(DM, DM_distr);
+	if(statistical_analysis == "Binned Poisson")
+		fiducial_spectrum = DM_Signals_Binned(DM, DM_distr);
+	else if(statistical_analysis == "Poisson")
+		fiducial_signals = DM_Signals_Total(DM, DM_distr);
+	else
+	{
+		// Yellin's methods and the unbinned likelihood share one tabulated spectrum.
+		fiducial_energy_spectrum = DM_Spectrum(DM, DM_distr);
+		if(statistical_analysis == "Unbinned Likelihood")
+			fiducial_signals = Unbinned_Signals(fiducial_energy_spectrum, fiducial_spectrum);
+		else
+			fiducial_gaps = Maximum_Gap_Signals(fiducial_energy_spectrum);
+	}
+}
+
+void DM_Detector::Reset_Fiducial_Values()
+{
+	using_fiducial_values		= false;
+	fiducial_coupling			= 0.0;
+	fiducial_kinematic_endpoint = 0.0;
+	fiducial_signals			= 0.0;
+	fiducial_spectrum.clear();
+	fiducial_gaps.clear();
+	fiducial_energy_spectrum = Tabulated_Spectrum();
+}
+
+double DM_Detector::Fiducial_Rescaling_Factor(const DM_Particle& DM) const
+{
+	int rescaling_power = 2;
+	if(DM.Interaction_Parameter_Is_Cross_Section())
+		rescaling_power = 1;
+	return pow(DM.Get_Interaction_Parameter(targets) / fiducial_coupling, rescaling_power);
+}
+
 // Limits/Constraints
-double DM_Detector::Upper_Limit(DM_Particle& DM, DM_Distribution& DM_distr, double certainty)
+// Upper limits are searched for within 10^-30 < interaction parameter < 10^10.
+const double log10_interaction_parameter_min = -30.0;
+const double log10_interaction_parameter_max = 10.0;
+
+double DM_Detector::Rescaled_Fiducial_Coupling(const DM_Particle& DM, double rescaling_factor) const
 {
-	bool found_limit = true;
+	double rescaling_power = DM.Interaction_Parameter_Is_Cross_Section() ? 1.0 : 2.0;
+	double coupling		   = fiducial_coupling * pow(rescaling_factor, 1.0 / rescaling_power);
+	if(coupling < pow(10.0, log10_interaction_parameter_min) || coupling > pow(10.0, log10_interaction_parameter_max))
+		return -1.0;
+	else
+		return coupling;
+}
 
-	double interaction_parameter_original = DM.Get_Interaction_Parameter(targets);
-	if(statistical_analysis == "Binned Poisson" || statistical_analysis == "Poisson")
+double DM_Detector::Fiducial_Upper_Limit_Poisson(const DM_Particle& DM, const std::vector<double>& events, double certainty) const
+{
+	std::vector<double> signals		= {fiducial_signals};
+	std::vector<double> backgrounds = {expected_background};
+	if(statistical_analysis == "Binned Poisson")
 	{
-		using_fiducial_values = true;
-		fiducial_coupling	  = interaction_parameter_original;
-		if(statistical_analysis == "Binned Poisson")
-			fiducial_spectrum = DM_Signals_Binned(DM, DM_distr);
+		signals		= fiducial_spectrum;
+		backgrounds = bin_expected_background;
+	}
+	double rescaling_factor = -1.0;
+	for(unsigned int i = 0; i < signals.size(); i++)
+	{
+		// CDF_Poisson(mu, n) = Q(n+1, mu), hence the largest allowed expectation value is given by the inverse of the regularized incomplete gamma function, unless it is taken from the Feldman-Cousins belt.
+		double maximum_signals;
+		if(using_feldman_cousins)
+			maximum_signals = Feldman_Cousins_Upper_Limit(std::lround(events[i]), backgrounds[i], certainty);
 		else
-			fiducial_signals = DM_Signals_Total(DM, DM_distr);
+			maximum_signals = boost::math::gamma_q_inv(events[i] + 1.0, 1.0 - certainty) - backgrounds[i];
+		if(maximum_signals <= 0.0)
+		{
+			// The background alone is already excluded.
+			return -1.0;
+		}
+		else if(signals[i] > 0.0 && (rescaling_factor < 0.0 || maximum_signals / signals[i] < rescaling_factor))
+			rescaling_factor = maximum_signals / signals[i];
 	}
+	return (rescaling_factor < 0.0) ? -1.0 : Rescaled_Fiducial_Coupling(DM, rescaling_factor);
+}
+
+double DM_Detector::Fiducial_Upper_Limit_Bayesian(const DM_Particle& DM, const std::vector<double>& events, double certainty) const
+{
+	std::vector<double> signals		= {fiducial_signals};
+	std::vector<double> backgrounds = {expected_background};
+	if(statistical_analysis == "Binned Poisson")
+	{
+		signals		= fiducial_spectrum;
+		backgrounds = bin_expected_background;
+	}
+	double total_signals = std::accumulate(signals.begin(), signals.end(), 0.0);
+	// The signals scale with the interaction parameter to the power p, such that its prior turns into a prior r^(1/p - 1) (flat) or 1/r (log) of the re-scaling factor r.
+	double rescaling_power	= DM.Interaction_Parameter_Is_Cross_Section() ? 1.0 : 2.0;
+	double prior_exponent	= (bayesian_prior == "Log") ? -1.0 : 1.0 / rescaling_power - 1.0;
+	double rescaling_min	= (bayesian_minimum_interaction_parameter > 0.0) ? pow(bayesian_minimum_interaction_parameter / fiducial_coupling, rescaling_power) : 0.0;
+	double rescaling_factor	= Bayesian_Upper_Limit_Signal_Strength(certainty, total_signals, events, signals, backgrounds, prior_exponent, rescaling_min);
+	return (rescaling_factor < 0.0) ? -1.0 : Rescaled_Fiducial_Coupling(DM, rescaling_factor);
+}
+
+double DM_Detector::Fiducial_Upper_Limit_Gaps(const DM_Particle& DM, const std::vector<double>& gaps, double certainty) const
+{
+	double total_signals = std::accumulate(gaps.begin(), gaps.end(), 0.0);
+	if(total_signals <= 0.0)
+		return -1.0;
+	// Find the rescaling of the fiducial gaps such that p = 1-certainty
+	std::function<double(double)> func = [this, &gaps, certainty](double log10_rescaling_factor) {
+		std::vector<double> rescaled_gaps;
+		for(auto& gap : gaps)
+			rescaled_gaps.push_back(pow(10.0, log10_rescaling_factor) * gap);
+		double p_value = (statistical_analysis == "Optimum Interval") ? obscura::P_Value_Optimum_Interval(rescaled_gaps) : obscura::P_Value_Maximum_Gap(rescaled_gaps);
+		return p_value - (1.0 - certainty);
+	};
+	// The limit lies between 0.1 and 10^6 expected signal events.
+	double log10_rescaling_min = -1.0 - log10(total_signals);
+	double log10_rescaling_max = 6.0 - log10(total_signals);
+	if(func(log10_rescaling_min) * func(log10_rescaling_max) > 0.0)
+		return -1.0;
+	double log10_rescaling_factor = libphysica::Find_Root(func, log10_rescaling_min, log10_rescaling_max, 1.0e-4);
+	return Rescaled_Fiducial_Coupling(DM, pow(10.0, log10_rescaling_factor));
+}
+
+double DM_Detector::Fiducial_Upper_Limit_Profiled_Poisson(const DM_Particle& DM, const std::vector<double>& events, double certainty) const
+{
+	std::vector<double> signals		= (statistical_analysis == "Binned Poisson") ? fiducial_spectrum : std::vector<double>({fiducial_signals});
+	std::vector<double> backgrounds	= (statistical_analysis == "Binned Poisson") ? bin_expected_background : std::vector<double>({expected_background});
+	double total_signals			= std::accumulate(signals.begin(), signals.end(), 0.0);
+	if(total_signals <= 0.0)
+		return -1.0;
+	// As in P_Value(), the P value is the smallest one of all bins, where CDF_Poisson(mu, n) = Q(n+1, mu) is continued to non-integer n.
+	std::function<double(double)> func = [this, &signals, &backgrounds, &events, certainty](double log10_rescaling_factor) {
+		std::vector<double> rescaled_signals;
+		for(auto& s : signals)
+			rescaled_signals.push_back(pow(10.0, log10_rescaling_factor) * s);
+		std::vector<double> normalizations = Background_Normalizations(rescaled_signals, events, backgrounds);
+		double p_value					   = 1.0;
+		for(unsigned int i = 0; i < signals.size(); i++)
+			p_value = std::min(p_value, boost::math::gamma_q(events[i] + 1.0, rescaled_signals[i] + normalizations[i] * backgrounds[i]));
+		return p_value - (1.0 - certainty);
+	};
+	// The limit lies between 0.1 and 10^6 expected signal events.
+	double log10_rescaling_min = -1.0 - log10(total_signals);
+	double log10_rescaling_max = 6.0 - log10(total_signals);
+	if(func(log10_rescaling_min) * func(log10_rescaling_max) > 0.0)
+		return -1.0;
+	double log10_rescaling_factor = libphysica::Find_Root(func, log10_rescaling_min, log10_rescaling_max, 1.0e-4);
+	return Rescaled_Fiducial_Coupling(DM, pow(10.0, log10_rescaling_factor));
+}
+
+double DM_Detector::Fiducial_Upper_Limit_Rescaled(const DM_Particle& DM, const std::vector<double>& events, double certainty) const
+{
+	std::string statistics = Poisson_Statistics();
+	if(statistics == "Bayesian")
+		return Fiducial_Upper_Limit_Bayesian(DM, events, certainty);
+	else if(statistics == "Likelihood Ratio")
+		return Fiducial_Upper_Limit_Likelihood_Ratio(DM, events, certainty);
+	else if(statistics == "Profiled Poisson")
+		return Fiducial_Upper_Limit_Profiled_Poisson(DM, events, certainty);
+	else
+		return Fiducial_Upper_Limit_Poisson(DM, events, certainty);
+}
+
+double DM_Detector::Upper_Limit(DM_Particle& DM, DM_Distribution& DM_distr, double certainty)
+{
+	return Upper_Limit(DM, DM_distr, certainty, -1.0);
+}
+
+std::vector<double> DM_Detector::Upper_Limit(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& certainties)
+{
+	return Upper_Limits_Fixed_Mass(DM, DM_distr, certainties, std::vector<double>(certainties.size(), -1.0));
+}
+
+// The limits at neighbouring masses of a limit curve typically differ by less than a decade.
+const double log10_warm_start_bracket_width = 1.0;
+const unsigned int warm_start_stride		= 4;
+
+unsigned int DM_Detector::Warm_Start_Mass_Index(unsigned int i)
+{
+	return i - i % warm_start_stride;
+}
+
+double DM_Detector::Upper_Limit(DM_Particle& DM, DM_Distribution& DM_distr, double certainty, double limit_guess)
+{
+	Set_Fiducial_Values(DM, DM_distr);
+	double upper_limit = Fiducial_Upper_Limit(DM, DM_distr, certainty, limit_guess);
+	Reset_Fiducial_Values();
+	return upper_limit;
+}
+
+std::vector<double> DM_Detector::Upper_Limits_Fixed_Mass(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& certainties, const std::vector<double>& limit_guesses)
+{
+	Set_Fiducial_Values(DM, DM_distr);
+	std::vector<double> upper_limits;
+	for(unsigned int i = 0; i < certainties.size(); i++)
+		upper_limits.push_back(Fiducial_Upper_Limit(DM, DM_distr, certainties[i], limit_guesses[i]));
+	Reset_Fiducial_Values();
+	return upper_limits;
+}
+
+double DM_Detector::Fiducial_Upper_Limit(DM_Particle& DM, DM_Distribution& DM_distr, double certainty, double limit_guess)
+{
+	// Except for CLs and Yellin's methods, the limit is found by re-scaling the fiducial signals instead of root finding of the P value.
+	bool poisson = (statistical_analysis == "Binned Poisson" || statistical_analysis == "Poisson");
+	if(poisson && !using_CLs)
+		return Fiducial_Upper_Limit_Rescaled(DM, Observed_Events(), certainty);
+	else if(statistical_analysis == "Unbinned Likelihood" && !using_CLs)
+		return Fiducial_Upper_Limit_Unbinned(DM, fiducial_spectrum, certainty);
+
+	bool found_limit = true;
+
+	double interaction_parameter_original = DM.Get_Interaction_Parameter(targets);
 	// Find the interaction parameter such that p = 1-certainty
 	std::function<double(double)> func = [this, &DM, &DM_distr, certainty](double log10_parameter) {
 		double parameter = pow(10.0, log10_parameter);
@@ -376,43 +1443,584 @@ double DM_Detector::Upper_Limit(DM_Particle& DM, DM_Distribution& DM_distr, doub
 		double p_value = P_Value(DM, DM_distr);
 		return p_value - (1.0 - certainty);
 	};
+	double log10_lower = log10_interaction_parameter_min;
+	double log10_upper = log10_interaction_parameter_max;
+	bool bracketed	   = false;
+	bool used_guess	   = false;
+	if(limit_guess > 0.0)
+	{
+		// Try a narrow bracket around the guess first. Since the p value decreases with the coupling, a failed bracket still tells us on which side of it the limit lies.
+		double log10_guess = log10(limit_guess);
+		double guess_lower = std::max(log10_guess - log10_warm_start_bracket_width, log10_interaction_parameter_min);
+		double guess_upper = std::min(log10_guess + log10_warm_start_bracket_width, log10_interaction_parameter_max);
+		if(guess_lower < guess_upper)
+		{
+			double func_guess_lower = func(guess_lower);
+			double func_guess_upper = func(guess_upper);
+			if(func_guess_lower * func_guess_upper <= 0.0)
+			{
+				bracketed	= true;
+				log10_lower = guess_lower;
+				log10_upper = guess_upper;
+			}
+			else if(func_guess_upper > 0.0)
+			{
+				log10_lower = guess_upper;
+				bracketed	= func_guess_upper * func(log10_upper) <= 0.0;
+			}
+			else
+			{
+				log10_upper = guess_lower;
+				bracketed	= func(log10_lower) * func_guess_lower <= 0.0;
+			}
+			used_guess = true;
+		}
+	}
+	if(!used_guess)
+		bracketed = func(log10_lower) * func(log10_upper) <= 0.0;
 	double log10_upper_bound;
-	if(func(-30.0) * func(10.0) > 0)
+	if(!bracketed)
 		found_limit = false;
 	else
-		log10_upper_bound = libphysica::Find_Root(func, -30.0, 10.0, 1.0e-4);
+		log10_upper_bound = libphysica::Find_Root(func, log10_lower, log10_upper, 1.0e-4);
 
 	DM.Set_Interaction_Parameter(interaction_parameter_original, targets);
-	if(statistical_analysis == "Binned Poisson" || statistical_analysis == "Poisson")
-	{
-		using_fiducial_values = false;
-		fiducial_coupling	  = 0.0;
-		fiducial_signals	  = 0.0;
-		fiducial_spectrum.clear();
-	}
 	if(found_limit)
 		return pow(10.0, log10_upper_bound);
 	else
 		return -1.0;
 }
 
-std::vector<std::vector<double>> DM_Detector::Upper_Limit_Curve(DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double> masses, double certainty)
+void DM_Detector::Use_Checkpoint(const std::string& filename, const std::string& configuration_hash)
 {
-	double mOriginal   = DM.mass;
-	double lowest_mass = Minimum_DM_Mass(DM, DM_distr);
-	std::vector<std::vector<double>> limit;
+	checkpoint_file = filename;
+	checkpoint_hash = configuration_hash;
+}
+
+std::string DM_Detector::Checkpoint_Header(const std::vector<double>& certainties) const
+{
+	std::ostringstream header;
+	header << std::setprecision(17) << "# Configuration: " << checkpoint_hash << "\tCertainty:";
+	for(auto& certainty : certainties)
+		header << " " << certainty;
+	header << "\tmDM and upper limits [natural units]";
+	return header.str();
+}
 
+void DM_Detector::Create_Checkpoint(const std::vector<double>& certainties)
+{
+	std::string header;
+	{
+		std::ifstream f(checkpoint_file);
+		if(f.is_open() && std::getline(f, header) && header == Checkpoint_Header(certainties))
+			return;
+	}
+	if(!header.empty())
+		std::cerr << "\nWarning in obscura::DM_Detector::Create_Checkpoint(): The checkpoint " << checkpoint_file << " belongs to a different configuration and will be overwritten." << std::endl;
+	std::ofstream f(checkpoint_file);
+	if(!f.is_open())
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::Create_Checkpoint(): The checkpoint " << checkpoint_file << " cannot be created." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	f << Checkpoint_Header(certainties) << std::endl;
+}
+
+std::vector<std::vector<double>> DM_Detector::Import_Checkpoint(const std::vector<double>& certainties) const
+{
+	std::vector<std::vector<double>> checkpoint;
+	std::ifstream f(checkpoint_file);
+	std::string header;
+	if(!f.is_open() || !std::getline(f, header) || header != Checkpoint_Header(certainties))
+		return checkpoint;
+	std::string line;
+	while(std::getline(f, line))
+	{
+		std::istringstream entries(line);
+		std::vector<double> entry;
+		double value;
+		while(entries >> value)
+			entry.push_back(value);
+		// An incomplete last line of an interrupted run is ignored.
+		if(entry.size() != 1 + certainties.size())
+			continue;
+		for(unsigned int i = 1; i < entry.size(); i++)
+			entry[i] = (entry[i] > 0.0) ? entry[i] : -1.0;
+		checkpoint.push_back(entry);
+	}
+	return checkpoint;
+}
+
+void DM_Detector::Append_To_Checkpoint(double mass, const std::vector<double>& limits) const
+{
+	std::ofstream f(checkpoint_file, std::ofstream::app);
+	f << std::setprecision(17) << mass;
+	for(auto& limit : limits)
+		f << "\t" << ((limit > 0.0) ? limit : -1.0);
+	f << std::endl;
+}
+
+std::vector<std::vector<double>> DM_Detector::Upper_Limits(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& masses, const std::vector<std::vector<double>>& limit_guesses, const std::vector<double>& certainties, unsigned int threads, unsigned int coarsening, bool use_checkpoint, std::function<void(unsigned int, const std::vector<double>&)> progress, std::function<bool()> stop)
+{
+	double mOriginal					  = DM.mass;
+	double interaction_parameter_original = DM.Get_Interaction_Parameter(targets);
+	double lowest_mass					  = Minimum_DM_Mass(DM, DM_distr);
+	std::vector<std::vector<double>> upper_limits(masses.size(), std::vector<double>(certainties.size(), -1.0));
+
+	// Masses in the checkpoint are not computed again, and the others are appended once they are finished.
+	std::vector<bool> finished(masses.size(), false);
+	std::mutex progress_mutex;
+	bool checkpointing = use_checkpoint && !checkpoint_file.empty();
+	if(checkpointing)
+	{
+		Create_Checkpoint(certainties);
+		for(auto& entry : Import_Checkpoint(certainties))
+			for(unsigned int i = 0; i < masses.size(); i++)
+				if(!finished[i] && std::fabs(entry[0] - masses[i]) <= 1.0e-10 * masses[i])
+				{
+					upper_limits[i] = std::vector<double>(entry.begin() + 1, entry.end());
+					finished[i]		= true;
+				}
+	}
+	auto report = [this, &progress_mutex, &progress, &masses, &upper_limits, checkpointing](unsigned int i, bool append_to_checkpoint) {
+		std::lock_guard<std::mutex> lock(progress_mutex);
+		if(checkpointing && append_to_checkpoint)
+			Append_To_Checkpoint(masses[i], upper_limits[i]);
+		if(progress)
+			progress(i, upper_limits[i]);
+	};
+	// Without a guess, the limit at the warm start mass seeds the root finding.
+	auto guesses = [&limit_guesses](unsigned int i, const std::vector<double>& warm_start_limits) {
+		std::vector<double> guess = limit_guesses[i];
+		for(unsigned int j = 0; j < guess.size(); j++)
+			if(guess[j] <= 0.0)
+				guess[j] = warm_start_limits[j];
+		return guess;
+	};
+
+	// 1. Collect the mass points to compute.
+	std::vector<unsigned int> mass_indices;
 	for(unsigned int i = 0; i < masses.size(); i++)
 	{
-		if(masses[i] < lowest_mass)
+		if(finished[i])
+			report(i, false);
+		else if(masses[i] < lowest_mass)
+			report(i, true);
+		else
+			mass_indices.push_back(i);
+	}
+
+	// 2. The limits of the warm start masses are computed first, and then the remaining ones.
+	std::vector<std::vector<unsigned int>> rounds(2);
+	for(unsigned int k = 0; k < mass_indices.size(); k++)
+		rounds[(Warm_Start_Mass_Index(mass_indices[k]) == mass_indices[k]) ? 0 : 1].push_back(k);
+
+	// 3. With a single thread and the full spectra, the DM particle, DM distribution, and detector are used themselves, and the mass is set right before each limit.
+	// Otherwise, the DM particle is prepared for each mass point in the same order, such that every mass point starts out from the same state for any number of threads, and each worker thread gets its own copies.
+	// Either way, the interaction parameter is re-set after each mass point, as the root finding of a limit does.
+	unsigned int workers = std::max(1u, std::min(Number_of_Threads(threads), static_cast<unsigned int>(mass_indices.size())));
+	bool serial			 = (workers == 1 && coarsening == 1);
+	std::vector<std::unique_ptr<DM_Particle>> DM_states(mass_indices.size());
+	if(!serial)
+	{
+		for(auto& round_points : rounds)
+			for(auto& k : round_points)
+			{
+				DM.Set_Mass(masses[mass_indices[k]]);
+				DM_states[k] = std::unique_ptr<DM_Particle>(DM.Clone());
+				DM.Set_Interaction_Parameter(DM.Get_Interaction_Parameter(targets), targets);
+			}
+	}
+	Worker_Copies copies = Copies_For_Workers(DM, DM_distr, workers, coarsening);
+
+	// 4. Within each round, the masses are distributed dynamically over the threads.
+	for(unsigned int round = 0; round < 2; round++)
+	{
+		const std::vector<unsigned int>& round_points = rounds[round];
+		Parallel_For(round_points.size(), workers, [this, &upper_limits, &mass_indices, &DM, &DM_states, &copies, &masses, &report, &stop, &guesses, &certainties, &round_points, round, serial](unsigned int n, unsigned int worker) {
+			if(stop && stop())
+				return;
+			unsigned int k						  = round_points[n];
+			unsigned int index					  = mass_indices[k];
+			std::vector<double> warm_start_limits = (round == 0) ? std::vector<double>(certainties.size(), -1.0) : upper_limits[Warm_Start_Mass_Index(index)];
+			if(serial)
+			{
+				DM.Set_Mass(masses[index]);
+				upper_limits[index] = Upper_Limits_Fixed_Mass(DM, *copies.distributions[worker], certainties, guesses(index, warm_start_limits));
+				DM.Set_Interaction_Parameter(DM.Get_Interaction_Parameter(targets), targets);
+			}
+			else
+				upper_limits[index] = copies.detectors[worker]->Upper_Limits_Fixed_Mass(*DM_states[k], *copies.distributions[worker], certainties, guesses(index, warm_start_limits));
+			report(index, true);
+		});
+	}
+	// Changing the mass back and forth can alter the interaction parameter in the last digits, so it is restored as well.
+	DM.Set_Mass(mOriginal);
+	DM.Set_Interaction_Parameter(interaction_parameter_original, targets);
+	return upper_limits;
+}
+
+// One curve of {mass, limit} per certainty level, leaving out the masses without a limit
+static std::vector<std::vector<std::vector<double>>> Limit_Curves(const std::vector<double>& masses, const std::vector<std::vector<double>>& upper_limits, unsigned int certainty_levels)
+{
+	std::vector<std::vector<std::vector<double>>> limits(certainty_levels);
+	for(unsigned int j = 0; j < certainty_levels; j++)
+		for(unsigned int i = 0; i < masses.size(); i++)
+			if(upper_limits[i][j] > 0.0)
+				limits[j].push_back(std::vector<double> {masses[i], upper_limits[i][j]});
+	return limits;
+}
+
+std::vector<std::vector<double>> DM_Detector::Upper_Limit_Curve(DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double> masses, double certainty, unsigned int threads)
+{
+	return Upper_Limit_Curve(DM, DM_distr, masses, std::vector<double> {certainty}, threads)[0];
+}
+
+std::vector<std::vector<std::vector<double>>> DM_Detector::Upper_Limit_Curve(DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double> masses, const std::vector<double>& certainties, unsigned int threads)
+{
+	std::vector<std::vector<double>> upper_limits = Upper_Limits(DM, DM_distr, masses, std::vector<std::vector<double>>(masses.size(), std::vector<double>(certainties.size(), -1.0)), certainties, threads);
+	return Limit_Curves(masses, upper_limits, certainties.size());
+}
+
+std::vector<std::vector<double>> DM_Detector::Upper_Limit_Curve_Adaptive(DM_Particle& DM, DM_Distribution& DM_distr, double mass_min, double mass_max, unsigned int initial_masses, double certainty, double tolerance, unsigned int refinements, unsigned int threads)
+{
+	return Upper_Limit_Curve_Adaptive(DM, DM_distr, mass_min, mass_max, initial_masses, std::vector<double> {certainty}, tolerance, refinements, threads)[0];
+}
+
+bool DM_Detector::Refine_Limit_Curve(DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double>& masses, std::vector<std::vector<double>>& limits, const std::vector<double>& certainties, double tolerance, unsigned int threads)
+{
+	// 1. Mark the intervals where the limit first appears (or disappears), and the intervals around points where the log-log curve bends by more than the tolerance, for any of the certainty levels.
+	std::vector<bool> bisect(masses.size() - 1, false);
+	for(unsigned int j = 0; j < certainties.size(); j++)
+	{
+		for(unsigned int i = 0; i + 1 < masses.size(); i++)
+			if((limits[i][j] > 0.0) != (limits[i + 1][j] > 0.0))
+				bisect[i] = true;
+		for(unsigned int i = 1; i + 1 < masses.size(); i++)
+		{
+			if(limits[i - 1][j] <= 0.0 || limits[i][j] <= 0.0 || limits[i + 1][j] <= 0.0)
+				continue;
+			double x						= log10(masses[i] / masses[i - 1]) / log10(masses[i + 1] / masses[i - 1]);
+			double log10_limit_interpolated = (1.0 - x) * log10(limits[i - 1][j]) + x * log10(limits[i + 1][j]);
+			if(std::fabs(log10(limits[i][j]) - log10_limit_interpolated) > tolerance)
+				bisect[i - 1] = bisect[i] = true;
+		}
+	}
+
+	// 2. Compute the limits at the logarithmic midpoints of the marked intervals, starting from the neighbouring limits.
+	std::vector<double> new_masses;
+	std::vector<std::vector<double>> limit_guesses;
+	for(unsigned int i = 0; i + 1 < masses.size(); i++)
+		if(bisect[i])
+		{
+			new_masses.push_back(sqrt(masses[i] * masses[i + 1]));
+			std::vector<double> guesses;
+			for(unsigned int j = 0; j < certainties.size(); j++)
+				guesses.push_back((limits[i][j] > 0.0 && limits[i + 1][j] > 0.0) ? sqrt(limits[i][j] * limits[i + 1][j]) : std::max(limits[i][j], limits[i + 1][j]));
+			limit_guesses.push_back(guesses);
+		}
+	if(new_masses.empty())
+		return false;
+	std::vector<std::vector<double>> new_limits = Upper_Limits(DM, DM_distr, new_masses, limit_guesses, certainties, threads);
+
+	// 3. Merge the new mass points into the grid.
+	std::vector<double> refined_masses;
+	std::vector<std::vector<double>> refined_limits;
+	for(unsigned int i = 0, j = 0; i < masses.size(); i++)
+	{
+		refined_masses.push_back(masses[i]);
+		refined_limits.push_back(limits[i]);
+		if(i + 1 < masses.size() && bisect[i])
+		{
+			refined_masses.push_back(new_masses[j]);
+			refined_limits.push_back(new_limits[j]);
+			j++;
+		}
+	}
+	masses = refined_masses;
+	limits = refined_limits;
+	return true;
+}
+
+std::vector<std::vector<std::vector<double>>> DM_Detector::Upper_Limit_Curve_Adaptive(DM_Particle& DM, DM_Distribution& DM_distr, double mass_min, double mass_max, unsigned int initial_masses, const std::vector<double>& certainties, double tolerance, unsigned int refinements, unsigned int threads)
+{
+	std::vector<double> masses				= libphysica::Log_Space(mass_min, mass_max, initial_masses);
+	std::vector<std::vector<double>> limits = Upper_Limits(DM, DM_distr, masses, std::vector<std::vector<double>>(masses.size(), std::vector<double>(certainties.size(), -1.0)), certainties, threads);
+	for(unsigned int refinement = 0; refinement < refinements; refinement++)
+		if(!Refine_Limit_Curve(DM, DM_distr, masses, limits, certainties, tolerance, threads))
+			break;
+	return Limit_Curves(masses, limits, certainties.size());
+}
+
+std::vector<std::vector<double>> DM_Detector::Upper_Limit_Curve_Progressive(DM_Particle& DM, DM_Distribution& DM_distr, double mass_min, double mass_max, std::function<void(const std::vector<std::vector<double>>&, unsigned int)> callback, unsigned int initial_masses, double certainty, double tolerance, unsigned int refinements, double time_budget, unsigned int coarsening, unsigned int threads)
+{
+	if(coarsening == 0)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::Upper_Limit_Curve_Progressive(): The coarsening factor has to be positive." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	auto start_time = std::chrono::steady_clock::now();
+
+	auto within_time_budget = [start_time, time_budget]() {
+		return time_budget <= 0.0 || std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count() < time_budget;
+	};
+
+	// Every pass hands the intermediate curve to the callback.
+	std::vector<double> certainties = {certainty};
+	unsigned int pass				= 0;
+
+	auto report = [&callback, &pass](const std::vector<double>& masses, const std::vector<std::vector<double>>& limits) {
+		if(callback)
+			callback(Limit_Curves(masses, limits, 1)[0], pass);
+		pass++;
+	};
+
+	// 1. Coarse pass with the sparse mass grid and coarser spectra, which are not written to a checkpoint.
+	std::vector<double> masses = libphysica::Log_Space(mass_min, mass_max, initial_masses);
+	std::vector<std::vector<double>> limits(masses.size(), std::vector<double>(1, -1.0));
+	if(coarsening > 1)
+	{
+		limits = Upper_Limits(DM, DM_distr, masses, limits, certainties, threads, coarsening, false);
+		report(masses, limits);
+		if(!within_time_budget())
+			return Limit_Curves(masses, limits, 1)[0];
+	}
+
+	// 2. Full fidelity on the same grid, starting from the coarse limits.
+	limits = Upper_Limits(DM, DM_distr, masses, limits, certainties, threads);
+	report(masses, limits);
+
+	// 3. Refinements of the grid until the tolerance or the time budget is reached.
+	for(unsigned int refinement = 0; refinement < refinements && within_time_budget(); refinement++)
+	{
+		if(!Refine_Limit_Curve(DM, DM_distr, masses, limits, certainties, tolerance, threads))
+			break;
+		report(masses, limits);
+	}
+	return Limit_Curves(masses, limits, 1)[0];
+}
+
+// Expected sensitivity
+// Quantiles of the limits from background-only pseudo-experiments, corresponding to the median and the 1 and 2 sigma bands.
+const std::vector<double> expected_limits_quantiles = {0.02275, 0.15866, 0.5, 0.84134, 0.97725};
+
+std::vector<double> DM_Detector::Expected_Limits(DM_Particle& DM, DM_Distribution& DM_distr, double certainty, unsigned int toys, unsigned long int seed, unsigned int threads)
+{
+	if(toys == 0)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::Expected_Limits(): The number of pseudo-experiments must be positive." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+
+	// The signals are computed only once for all pseudo-experiments.
+	Set_Fiducial_Values(DM, DM_distr);
+	std::vector<double> limits(toys, 0.0);
+
+	// The observed data of the detector are replaced by the pseudo-experiments, such that their limits follow the same statistics as Upper_Limit(), e.g. CLs, the likelihood ratio, or a profiled background.
+	// With multiple threads, each worker thread gets its own copy of the detector (with the fiducial values), DM particle, and DM distribution, whose CLs pseudo-experiments run on the worker thread.
+	unsigned int workers = std::min(Number_of_Threads(threads), toys);
+	Worker_Copies copies = Copies_For_Workers(DM, DM_distr, workers);
+	unsigned long int observed_events_original					= observed_events;
+	std::vector<unsigned long int> bin_observed_events_original	= bin_observed_events;
+	std::vector<double> maximum_gap_energy_data_original		= maximum_gap_energy_data;
+
+	if(statistical_analysis == "Poisson" || statistical_analysis == "Binned Poisson")
+	{
+		std::vector<double> backgrounds = (statistical_analysis == "Binned Poisson") ? bin_expected_background : std::vector<double> {expected_background};
+		Parallel_For(toys, workers, [this, &limits, &backgrounds, &copies, certainty, seed](unsigned int toy, unsigned int worker) {
+			std::mt19937_64 generator(seed + toy);
+			std::vector<unsigned long int> events;
+			for(auto& background : backgrounds)
+			{
+				std::poisson_distribution<unsigned long int> poisson_distribution(background);
+				events.push_back((background > 0.0) ? poisson_distribution(generator) : 0);
+			}
+			if(statistical_analysis == "Binned Poisson")
+				copies.detectors[worker]->bin_observed_events = events;
+			else
+				copies.detectors[worker]->observed_events = events[0];
+			limits[toy] = copies.detectors[worker]->Fiducial_Upper_Limit(*copies.particles[worker], *copies.distributions[worker], certainty, -1.0);
+		});
+	}
+	else if(statistical_analysis == "Unbinned Likelihood")
+	{
+		Parallel_For(toys, workers, [this, &limits, &copies, certainty, seed](unsigned int toy, unsigned int worker) {
+			std::mt19937_64 generator(seed + toy);
+			std::uniform_real_distribution<double> energy_distribution(energy_threshold, energy_max);
+			std::vector<double> events;
+			if(expected_background > 0.0)
+			{
+				std::poisson_distribution<unsigned long int> poisson_distribution(expected_background);
+				for(unsigned long int i = poisson_distribution(generator); i > 0; i--)
+					events.push_back(energy_distribution(generator));
+			}
+			std::sort(events.begin(), events.end());
+			copies.detectors[worker]->fiducial_spectrum		  = Unbinned_Event_Spectrum(fiducial_energy_spectrum, events);
+			copies.detectors[worker]->maximum_gap_energy_data = events;
+			copies.detectors[worker]->maximum_gap_energy_data.insert(copies.detectors[worker]->maximum_gap_energy_data.begin(), energy_threshold);
+			copies.detectors[worker]->maximum_gap_energy_data.push_back(energy_max);
+			limits[toy] = copies.detectors[worker]->Fiducial_Upper_Limit(*copies.particles[worker], *copies.distributions[worker], certainty, -1.0);
+		});
+	}
+	else
+	{
+		// Gaps of the fiducial spectrum, with the background events distributed uniformly between the lowest and highest energy of the data.
+		Parallel_For(toys, workers, [this, &DM, &limits, certainty, seed](unsigned int toy, unsigned int worker) {
+			std::mt19937_64 generator(seed + toy);
+			std::uniform_real_distribution<double> energy_distribution(energy_threshold, energy_max);
+			std::vector<double> events = {energy_threshold, energy_max};
+			if(expected_background > 0.0)
+			{
+				std::poisson_distribution<unsigned long int> poisson_distribution(expected_background);
+				for(unsigned long int i = poisson_distribution(generator); i > 0; i--)
+					events.push_back(energy_distribution(generator));
+			}
+			std::sort(events.begin(), events.end());
+			std::vector<double> gaps;
+			for(unsigned int i = 0; i + 1 < events.size(); i++)
+				gaps.push_back(fiducial_energy_spectrum.Signals(events[i], events[i + 1]));
+			limits[toy] = Fiducial_Upper_Limit_Gaps(DM, gaps, certainty);
+		});
+	}
+	observed_events			= observed_events_original;
+	bin_observed_events		= bin_observed_events_original;
+	maximum_gap_energy_data	= maximum_gap_energy_data_original;
+	Reset_Fiducial_Values();
+
+	// Pseudo-experiments where the background alone is excluded count as a limit of zero.
+	for(auto& limit : limits)
+		limit = std::max(limit, 0.0);
+	std::sort(limits.begin(), limits.end());
+	std::vector<double> quantiles;
+	for(auto& quantile : expected_limits_quantiles)
+	{
+		double index	= quantile * (toys - 1);
+		unsigned int i	= std::min(static_cast<unsigned int>(index), toys - 1);
+		unsigned int i2	= std::min(i + 1, toys - 1);
+		quantiles.push_back(limits[i] + (index - i) * (limits[i2] - limits[i]));
+	}
+	return quantiles;
+}
+
+std::vector<std::vector<double>> DM_Detector::Expected_Limit_Curve(DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double> masses, double certainty, unsigned int toys, unsigned long int seed, unsigned int threads)
+{
+	double mOriginal   = DM.mass;
+	double lowest_mass = Minimum_DM_Mass(DM, DM_distr);
+	std::vector<std::vector<double>> bands;
+	for(auto& mass : masses)
+	{
+		if(mass < lowest_mass)
 			continue;
-		DM.Set_Mass(masses[i]);
-		double upper_limit = Upper_Limit(DM, DM_distr, certainty);
-		if(upper_limit > 0.0)
-			limit.push_back(std::vector<double> {masses[i], upper_limit});
+		DM.Set_Mass(mass);
+		std::vector<double> expected_limits = Expected_Limits(DM, DM_distr, certainty, toys, seed, threads);
+		if(expected_limits[2] > 0.0)
+		{
+			expected_limits.insert(expected_limits.begin(), mass);
+			bands.push_back(expected_limits);
+		}
 	}
 	DM.Set_Mass(mOriginal);
-	return limit;
+	return bands;
+}
+
+double DM_Detector::Asimov_Limit(DM_Particle& DM, DM_Distribution& DM_distr, double certainty)
+{
+	if(statistical_analysis != "Poisson" && statistical_analysis != "Binned Poisson")
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::Asimov_Limit(): The Asimov data set is only defined for (binned) Poisson statistics, not for " << statistical_analysis << "." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	else if(using_CLs)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::Asimov_Limit(): The CLs pseudo-experiments require integer observed events. Use Expected_Limits() instead." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	Set_Fiducial_Values(DM, DM_distr);
+	std::vector<double> asimov_events = (statistical_analysis == "Binned Poisson") ? bin_expected_background : std::vector<double> {expected_background};
+	double upper_limit				  = Fiducial_Upper_Limit_Rescaled(DM, asimov_events, certainty);
+	Reset_Fiducial_Values();
+	return upper_limit;
+}
+
+std::vector<double> DM_Detector::Projected_Limits(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& exposures, const std::vector<double>& backgrounds, double certainty)
+{
+	Set_Fiducial_Values(DM, DM_distr);
+	double signals								= fiducial_signals;
+	std::vector<double> spectrum				= fiducial_spectrum;
+	double background_original					= expected_background;
+	std::vector<double> bin_background_original	= bin_expected_background;
+	std::vector<double> background_shape(number_of_bins, 1.0 / std::max(number_of_bins, 1u));
+	double total_background = std::accumulate(bin_expected_background.begin(), bin_expected_background.end(), 0.0);
+	if(total_background > 0.0)
+		for(unsigned int i = 0; i < bin_expected_background.size(); i++)
+			background_shape[i] = bin_expected_background[i] / total_background;
+
+	// The fiducial signals are re-scaled to the projected exposure, and the Asimov data set equals the projected background.
+	std::vector<double> limits;
+	for(auto& projected_exposure : exposures)
+	{
+		double rescaling_factor = projected_exposure / exposure;
+		fiducial_signals		= rescaling_factor * signals;
+		for(unsigned int i = 0; i < spectrum.size(); i++)
+			fiducial_spectrum[i] = rescaling_factor * spectrum[i];
+		for(auto& background : backgrounds)
+		{
+			std::vector<double> asimov_events = {background};
+			expected_background				  = background;
+			if(statistical_analysis == "Binned Poisson")
+			{
+				for(unsigned int i = 0; i < number_of_bins; i++)
+					bin_expected_background[i] = background * background_shape[i];
+				asimov_events = bin_expected_background;
+			}
+			limits.push_back(Fiducial_Upper_Limit_Rescaled(DM, asimov_events, certainty));
+		}
+	}
+	expected_background		= background_original;
+	bin_expected_background = bin_background_original;
+	Reset_Fiducial_Values();
+	return limits;
+}
+
+std::vector<std::vector<std::vector<double>>> DM_Detector::Projected_Limit_Curves(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& masses, const std::vector<double>& exposures, const std::vector<double>& backgrounds, double certainty, unsigned int threads)
+{
+	if(statistical_analysis != "Poisson" && statistical_analysis != "Binned Poisson")
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::Projected_Limit_Curves(): Projections are only defined for (binned) Poisson statistics, not for " << statistical_analysis << "." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	else if(using_CLs)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::Projected_Limit_Curves(): The CLs pseudo-experiments require integer observed events and cannot be applied to the Asimov data set." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	else if(exposure <= 0.0 || std::any_of(exposures.begin(), exposures.end(), [](double e) { return e <= 0.0; }) || std::any_of(backgrounds.begin(), backgrounds.end(), [](double b) { return b < 0.0; }))
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector::Projected_Limit_Curves(): The exposures have to be positive and the backgrounds non-negative." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	double m_original  = DM.mass;
+	double lowest_mass = Minimum_DM_Mass(DM, DM_distr);
+	std::vector<unsigned int> mass_indices;
+	for(unsigned int i = 0; i < masses.size(); i++)
+		if(masses[i] >= lowest_mass)
+			mass_indices.push_back(i);
+
+	std::vector<std::vector<double>> limits(masses.size());
+	unsigned int workers = std::min(Number_of_Threads(threads), static_cast<unsigned int>(mass_indices.size()));
+	Worker_Copies copies = Copies_For_Workers(DM, DM_distr, workers);
+	Parallel_For(mass_indices.size(), workers, [&limits, &masses, &mass_indices, &exposures, &backgrounds, &copies, certainty](unsigned int k, unsigned int worker) {
+		copies.particles[worker]->Set_Mass(masses[mass_indices[k]]);
+		limits[mass_indices[k]] = copies.detectors[worker]->Projected_Limits(*copies.particles[worker], *copies.distributions[worker], exposures, backgrounds, certainty);
+	});
+
+	std::vector<std::vector<std::vector<double>>> curves(exposures.size() * backgrounds.size());
+	for(auto& i : mass_indices)
+		for(unsigned int c = 0; c < curves.size(); c++)
+			if(limits[i][c] > 0.0)
+				curves[c].push_back(std::vector<double> {masses[i], limits[i][c]});
+	DM.Set_Mass(m_original);
+	return curves;
 }
 
 // Energy spectrum
@@ -452,15 +2060,10 @@ std::vector<double> DM_Detector::DM_Signals_Energy_Bins(const DM_Particle& DM, D
 	}
 	else
 	{
-		std::function<double(double)> spectrum = [this, &DM, &DM_distr](double E) {
-			return dRdE(E, DM, DM_distr);
-		};
+		Tabulated_Spectrum spectrum = DM_Spectrum(DM, DM_distr);
 		std::vector<double> mu_i;
 		for(unsigned int i = 0; i < number_of_bins; i++)
-		{
-			double mu = exposure * libphysica::Integrate(spectrum, bin_energies[i], bin_energies[i + 1]);
-			mu_i.push_back(bin_efficiencies[i] * mu);
-		}
+			mu_i.push_back(bin_efficiencies[i] * spectrum.Signals(bin_energies[i], bin_energies[i + 1]));
 		return mu_i;
 	}
 }
@@ -478,6 +2081,16 @@ void DM_Detector::Print_Summary_Base(int MPI_rank) const
 				  << "\tObserved events:\t" << observed_events << std::endl
 				  << "\tExpected background:\t" << expected_background << std::endl
 				  << "\tStatistical analysis:\t" << statistical_analysis << std::endl;
+		if(profiling_background && (statistical_analysis == "Poisson" || statistical_analysis == "Binned Poisson"))
+			std::cout << "\t\tBackground normalization:\tprofiled " << (profiling_background_per_bin ? "per bin" : "globally") << " (" << libphysica::Round(100.0 * background_normalization_uncertainty) << "% uncertainty)" << std::endl;
+		if(using_CLs && (statistical_analysis == "Poisson" || statistical_analysis == "Binned Poisson" || statistical_analysis == "Unbinned Likelihood"))
+			std::cout << "\t\tP values:\tCLs (precision " << CLs_precision << ", at most " << CLs_maximum_toys << " toys)" << std::endl;
+		else if(using_likelihood_ratio && (statistical_analysis == "Poisson" || statistical_analysis == "Binned Poisson"))
+			std::cout << "\t\tP values:\tAsymptotic likelihood ratio" << std::endl;
+		if(using_feldman_cousins && (statistical_analysis == "Poisson" || statistical_analysis == "Binned Poisson"))
+			std::cout << "\t\tConfidence belts:\tFeldman-Cousins" << std::endl;
+		if(using_bayesian_limits && (statistical_analysis == "Poisson" || statistical_analysis == "Binned Poisson"))
+			std::cout << "\t\tUpper limits:\tBayesian (" << bayesian_prior << " prior)" << std::endl;
 		if(statistical_analysis == "Binned Poisson")
 		{
 			std::cout << "\t\tNumber of bins:\t" << number_of_bins << std::endl;
@@ -488,7 +2101,7 @@ void DM_Detector::Print_Summary_Base(int MPI_rank) const
 					std::cout << "\t\t" << i + 1 << "\t" << 100.0 * bin_efficiencies[i] << "\t\t" << bin_observed_events[i] << "\t\t" << bin_expected_background[i] << std::endl;
 			}
 		}
-		if(using_energy_threshold || using_energy_bins || statistical_analysis == "Maximum Gap")
+		if(using_energy_threshold || using_energy_bins || statistical_analysis == "Maximum Gap" || statistical_analysis == "Optimum Interval" || statistical_analysis == "Unbinned Likelihood")
 			std::cout << "\tRecoil energies [keV]:\t[" << libphysica::Round(energy_threshold / keV) << "," << libphysica::Round(energy_max / keV) << "]" << std::endl;
 		if(using_energy_bins)
 		{
@@ -0,0 +1,176 @@
+#include "obscura/Direct_Detection_Combination.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <limits>
+
+#include <boost/math/special_functions/erf.hpp>
+
+#include "libphysica/Numerics.hpp"
+#include "libphysica/Utilities.hpp"
+
+#include "obscura/Multithreading.hpp"
+#include "obscura/Statistical_Methods.hpp"
+
+namespace obscura
+{
+
+DM_Detector_Combination::DM_Detector_Combination(std::string label, const std::vector<DM_Detector*>& members)
+: targets(""), name(label)
+{
+	for(auto& member : members)
+		Add_Detector(*member);
+}
+
+void DM_Detector_Combination::Add_Detector(const DM_Detector& detector)
+{
+	if(detector.Statistical_Analysis() != "Poisson" && detector.Statistical_Analysis() != "Binned Poisson")
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector_Combination::Add_Detector(): Statistical analysis " << detector.Statistical_Analysis() << " of " << detector.name << " has no likelihood to combine." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	else if(!detectors.empty() && detector.Target_Particles() != targets)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector_Combination::Add_Detector(): Target particles of " << detector.name << " (" << detector.Target_Particles() << ") differ from the combination's target particles (" << targets << ")." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	targets = detector.Target_Particles();
+	detectors.push_back(std::unique_ptr<DM_Detector>(detector.Clone()));
+}
+
+unsigned int DM_Detector_Combination::Number_of_Detectors() const
+{
+	return detectors.size();
+}
+
+std::string DM_Detector_Combination::Target_Particles() const
+{
+	return targets;
+}
+
+double DM_Detector_Combination::Minimum_DM_Mass(DM_Particle& DM, const DM_Distribution& DM_distr) const
+{
+	double minimum_mass = std::numeric_limits<double>::infinity();
+	for(auto& detector : detectors)
+		minimum_mass = std::min(minimum_mass, detector->Minimum_DM_Mass(DM, DM_distr));
+	return minimum_mass;
+}
+
+void DM_Detector_Combination::Set_Fiducial_Values(DM_Particle& DM, DM_Distribution& DM_distr, unsigned int threads)
+{
+	Parallel_For(detectors.size(), threads, [this, &DM, &DM_distr](unsigned int i, unsigned int worker) {
+		std::unique_ptr<DM_Particle> DM_member(DM.Clone());
+		std::unique_ptr<DM_Distribution> DM_distr_member(DM_distr.Clone());
+		detectors[i]->Set_Fiducial_Values(*DM_member, *DM_distr_member);
+	});
+}
+
+void DM_Detector_Combination::Reset_Fiducial_Values()
+{
+	for(auto& detector : detectors)
+		detector->Reset_Fiducial_Values();
+}
+
+// Statistics
+double DM_Detector_Combination::Log_Likelihood(DM_Particle& DM, DM_Distribution& DM_distr, unsigned int threads)
+{
+	std::vector<double> log_likelihoods(detectors.size(), 0.0);
+	Parallel_For(detectors.size(), threads, [this, &DM, &DM_distr, &log_likelihoods](unsigned int i, unsigned int worker) {
+		std::unique_ptr<DM_Particle> DM_member(DM.Clone());
+		std::unique_ptr<DM_Distribution> DM_distr_member(DM_distr.Clone());
+		log_likelihoods[i] = detectors[i]->Log_Likelihood(*DM_member, *DM_distr_member);
+	});
+	double log_likelihood = 0.0;
+	for(auto& ll : log_likelihoods)
+		log_likelihood += ll;
+	return log_likelihood;
+}
+
+double DM_Detector_Combination::Fiducial_Log_Likelihood(DM_Particle& DM, DM_Distribution& DM_distr)
+{
+	// With fiducial values, the members only re-scale their signals, which is not worth distributing over threads.
+	double log_likelihood = 0.0;
+	for(auto& detector : detectors)
+		log_likelihood += detector->Log_Likelihood(DM, DM_distr);
+	return log_likelihood;
+}
+
+// Limits/Constraints
+// Upper limits are searched for within 10^-30 < interaction parameter < 10^10, as for the individual detectors.
+const double log10_combination_interaction_parameter_min = -30.0;
+const double log10_combination_interaction_parameter_max = 10.0;
+
+double DM_Detector_Combination::Upper_Limit(DM_Particle& DM, DM_Distribution& DM_distr, double certainty, unsigned int threads)
+{
+	if(detectors.empty())
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::DM_Detector_Combination::Upper_Limit(): The combination " << name << " has no detectors." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	double interaction_parameter_original = DM.Get_Interaction_Parameter(targets);
+	Set_Fiducial_Values(DM, DM_distr, threads);
+	std::function<double(double)> log_likelihood = [this, &DM, &DM_distr](double log10_parameter) {
+		DM.Set_Interaction_Parameter(pow(10.0, log10_parameter), targets);
+		return Fiducial_Log_Likelihood(DM, DM_distr);
+	};
+
+	// 1. Best fit, where the log likelihood is unimodal in the coupling (concave in the signal strength), possibly with its maximum at vanishing coupling.
+	double log10_best_fit	  = Golden_Section_Maximum(log_likelihood, log10_combination_interaction_parameter_min, log10_combination_interaction_parameter_max, 1.0e-4);
+	double log_likelihood_max = log_likelihood(log10_best_fit);
+	if(log_likelihood(log10_combination_interaction_parameter_min) >= log_likelihood_max)
+	{
+		log10_best_fit	   = log10_combination_interaction_parameter_min;
+		log_likelihood_max = log_likelihood(log10_best_fit);
+	}
+
+	// 2. Find the interaction parameter above the best fit such that the likelihood ratio reaches the critical value.
+	double z						   = sqrt(2.0) * boost::math::erf_inv(2.0 * certainty - 1.0);
+	std::function<double(double)> func = [&log_likelihood, log_likelihood_max, z](double log10_parameter) {
+		return 2.0 * (log_likelihood_max - log_likelihood(log10_parameter)) - z * z;
+	};
+	double upper_limit = -1.0;
+	if(func(log10_combination_interaction_parameter_max) > 0.0)
+		upper_limit = pow(10.0, libphysica::Find_Root(func, log10_best_fit, log10_combination_interaction_parameter_max, 1.0e-4));
+
+	DM.Set_Interaction_Parameter(interaction_parameter_original, targets);
+	Reset_Fiducial_Values();
+	return upper_limit;
+}
+
+std::vector<std::vector<double>> DM_Detector_Combination::Upper_Limit_Curve(DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double> masses, double certainty, unsigned int threads)
+{
+	double mOriginal   = DM.mass;
+	double lowest_mass = Minimum_DM_Mass(DM, DM_distr);
+	std::vector<std::vector<double>> limit;
+	for(auto& mass : masses)
+	{
+		if(mass < lowest_mass)
+			continue;
+		DM.Set_Mass(mass);
+		double upper_limit = Upper_Limit(DM, DM_distr, certainty, threads);
+		if(upper_limit > 0.0)
+			limit.push_back(std::vector<double> {mass, upper_limit});
+	}
+	DM.Set_Mass(mOriginal);
+	return limit;
+}
+
+void DM_Detector_Combination::Print_Summary(int MPI_rank) const
+{
+	if(MPI_rank == 0)
+	{
+		std::cout << std::endl
+				  << "----------------------------------------" << std::endl
+				  << "Combination summary:\t" << name << std::endl
+				  << "\tTarget particles:\t" << targets << std::endl
+				  << "\tDetectors:\t" << detectors.size() << std::endl;
+		for(auto& detector : detectors)
+			std::cout << "\t\t" << detector->name << " (" << detector->Statistical_Analysis() << ")" << std::endl;
+		std::cout << "----------------------------------------" << std::endl
+				  << std::endl;
+	}
+}
+
+}	// namespace obscura
@@ -27,72 +27,85 @@ unsigned int Electron_Hole_Pairs(double Ee, const Crystal& target)
 }
 
 bool dRdE_Crystal_warned = false;
-double dRdEe_Crystal(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal)
+double dRdEe_Crystal(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal, unsigned int q_stride)
 {
-	if(Ee > target_crystal.E_max)
-	{
-		if(!dRdE_Crystal_warned)
+	return dRdEe_Crystal(std::vector<double>({Ee}), DM, DM_distr, target_crystal, q_stride)[0];
+}
+
+std::vector<double> dRdEe_Crystal(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal, unsigned int q_stride)
+{
+	std::vector<double> integrals(energies.size(), 0.0);
+	for(auto& Ee : energies)
+		if(Ee > target_crystal.E_max && !dRdE_Crystal_warned)
 		{
 			std::cerr << libphysica::Formatted_String("Warning", "Yellow", true) << " in dRdEe_Crystal: Ee lies beyond the tabulated crystal form factor. Return 0." << std::endl
 					  << "\tEe = " << libphysica::Round(Ee / eV) << " eV > E_max = " << libphysica::Round(target_crystal.E_max / eV) << " eV" << std::endl
 					  << "\t(Warning will not be repeated.)" << std::endl;
 			dRdE_Crystal_warned = true;
 		}
-		return 0;
-	}
-	double N_T		= 1.0 / target_crystal.M_cell;
-	double integral = 0.0;
-	for(int qi = 0; qi < target_crystal.N_q; qi++)
+	double N_T			  = 1.0 / target_crystal.M_cell;
+	double dq			  = q_stride * target_crystal.dq;
+	double vMax			  = DM_distr.Maximum_DM_Speed();
+	bool use_eta_function = DM.DD_use_eta_function && DM_distr.DD_use_eta_function;
+	for(int qi = 0; qi < target_crystal.N_q; qi += q_stride)
 	{
-		double q	= (qi + 1) * target_crystal.dq;
-		double vMin = vMinimal_Electrons(q, Ee, DM.mass);
-		double vMax = DM_distr.Maximum_DM_Speed();
-		if(vMin > vMax)
-			continue;
-		else if(DM.DD_use_eta_function && DM_distr.DD_use_eta_function)
+		double q = (qi + 1) * target_crystal.dq;
+		for(unsigned int i = 0; i < energies.size(); i++)
 		{
-			double vDM = 1e-3;	 // cancels in v^2 * dSigma/dq^2
-			integral += 2.0 * q * target_crystal.dq * DM_distr.DM_density / DM.mass * DM_distr.Eta_Function(vMin) * vDM * vDM * DM.d2Sigma_dq2_dEe_Crystal(q, Ee, vDM, target_crystal);
-		}
-		else
-		{
-			auto integrand = [&DM_distr, &DM, q, Ee, &target_crystal](double v) {
-				return DM_distr.Differential_DM_Flux(v, DM.mass) * DM.d2Sigma_dq2_dEe_Crystal(q, Ee, v, target_crystal);
-			};
-			integral += 2.0 * q * target_crystal.dq * libphysica::Integrate(integrand, vMin, vMax);
+			double Ee	= energies[i];
+			double vMin = vMinimal_Electrons(q, Ee, DM.mass);
+			if(Ee > target_crystal.E_max || vMin > vMax)
+				continue;
+			else if(use_eta_function)
+			{
+				double vDM = 1e-3;	 // cancels in v^2 * dSigma/dq^2
+				integrals[i] += 2.0 * q * dq * DM_distr.DM_density / DM.mass * DM_distr.Eta_Function(vMin) * vDM * vDM * DM.d2Sigma_dq2_dEe_Crystal(q, Ee, vDM, target_crystal);
+			}
+			else
+			{
+				auto integrand = [&DM_distr, &DM, q, Ee, &target_crystal](double v) {
+					return DM_distr.Differential_DM_Flux(v, DM.mass) * DM.d2Sigma_dq2_dEe_Crystal(q, Ee, v, target_crystal);
+				};
+				integrals[i] += 2.0 * q * dq * libphysica::Integrate(integrand, vMin, vMax);
+			}
 		}
 	}
-	return N_T * integral;
+	for(auto& integral : integrals)
+		integral *= N_T;
+	return integrals;
 }
 
-double R_Q_Crystal(int Q, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal)
+double R_Q_Crystal(int Q, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal, unsigned int q_stride)
 {
 	// Energy threshold
 	double Emin = Minimum_Electron_Energy(Q, target_crystal);
 	double Emax = Minimum_Electron_Energy(Q + 1, target_crystal);
 	// Integrate over energies
-	double sum = 0.0;
+	std::vector<double> energies;
 	for(int Ei = (Emin / target_crystal.dE); Ei < target_crystal.N_E; Ei++)
 	{
 		double E = (Ei + 1) * target_crystal.dE;
 		if(E > Emax)
 			break;
-		sum += target_crystal.dE * dRdEe_Crystal(E, DM, DM_distr, target_crystal);
+		energies.push_back(E);
 	}
+	double sum = 0.0;
+	for(auto& dRdE : dRdEe_Crystal(energies, DM, DM_distr, target_crystal, q_stride))
+		sum += target_crystal.dE * dRdE;
 	return sum;
 }
 
-double R_total_Crystal(int Qthreshold, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal)
+double R_total_Crystal(int Qthreshold, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal, unsigned int q_stride)
 {
 	// Energy threshold
 	double E_min = Minimum_Electron_Energy(Qthreshold, target_crystal);
 	// Integrate over energies
-	double sum = 0.0;
+	std::vector<double> energies;
 	for(int Ei = (E_min / target_crystal.dE); Ei < target_crystal.N_E; Ei++)
-	{
-		double E = (Ei + 1) * target_crystal.dE;
-		sum += target_crystal.dE * dRdEe_Crystal(E, DM, DM_distr, target_crystal);
-	}
+		energies.push_back((Ei + 1) * target_crystal.dE);
+	double sum = 0.0;
+	for(auto& dRdE : dRdEe_Crystal(energies, DM, DM_distr, target_crystal, q_stride))
+		sum += target_crystal.dE * dRdE;
 	return sum;
 }
 
@@ -125,7 +138,15 @@ double DM_Detector_Crystal::Minimum_DM_Speed(DM_Particle& DM) const
 
 double DM_Detector_Crystal::dRdE(double E, const DM_Particle& DM, DM_Distribution& DM_distr)
 {
-	return flat_efficiency * dRdEe_Crystal(E, DM, DM_distr, target_crystal);
+	return flat_efficiency * dRdEe_Crystal(E, DM, DM_distr, target_crystal, spectrum_coarsening);
+}
+
+std::vector<double> DM_Detector_Crystal::dRdE_Batch(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr)
+{
+	std::vector<double> dRdE = dRdEe_Crystal(energies, DM, DM_distr, target_crystal, spectrum_coarsening);
+	for(auto& value : dRdE)
+		value *= flat_efficiency;
+	return dRdE;
 }
 
 double DM_Detector_Crystal::DM_Signals_Total(const DM_Particle& DM, DM_Distribution& DM_distr)
@@ -136,16 +157,11 @@ double DM_Detector_Crystal::DM_Signals_Total(const DM_Particle& DM, DM_Distribut
 		std::vector<double> binned_events = DM_Signals_Binned(DM, DM_distr);
 		N								  = std::accumulate(binned_events.begin(), binned_events.end(), 0.0);
 	}
-	else if(using_energy_threshold || statistical_analysis == "Maximum Gap")
-	{
-		std::function<double(double)> spectrum = [this, &DM, &DM_distr](double E) {
-			return dRdE(E, DM, DM_distr);
-		};
-		N = exposure * libphysica::Integrate(spectrum, energy_threshold, energy_max);
-	}
+	else if(using_energy_threshold || statistical_analysis == "Maximum Gap" || statistical_analysis == "Optimum Interval")
+		N = DM_Spectrum(DM, DM_distr).Total_Signals();
 	else if(using_Q_threshold)
 	{
-		N = exposure * flat_efficiency * R_total_Crystal(Q_threshold, DM, DM_distr, target_crystal);
+		N = exposure * flat_efficiency * R_total_Crystal(Q_threshold, DM, DM_distr, target_crystal, spectrum_coarsening);
 	}
 	return N;
 }
@@ -206,7 +222,7 @@ std::vector<double> DM_Detector_Crystal::DM_Signals_Q_Bins(const DM_Particle& DM
 		std::vector<double> signals;
 		for(unsigned int Q = Q_threshold; Q < Q_threshold + number_of_bins; Q++)
 		{
-			signals.push_back(exposure * flat_efficiency * bin_efficiencies[Q - 1] * R_Q_Crystal(Q, DM, DM_distr, target_crystal));
+			signals.push_back(exposure * flat_efficiency * bin_efficiencies[Q - 1] * R_Q_Crystal(Q, DM, DM_distr, target_crystal, spectrum_coarsening));
 		}
 		return signals;
 	}
@@ -154,6 +154,24 @@ double DM_Detector_Ionization::dRdE(double E, const DM_Particle& DM, DM_Distribu
 	return dRdE;
 }
 
+std::vector<double> DM_Detector_Ionization::dRdE_Batch(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr)
+{
+	std::vector<double> dRdE(energies.size(), 0.0);
+	for(unsigned int i = 0; i < atomic_targets.size(); i++)
+	{
+		std::vector<double> dRdE_atom(energies.size(), 0.0);
+		for(auto& electron : atomic_targets[i].electrons)
+		{
+			std::vector<double> dRdE_shell = dRdE_Ionization_Batch(energies, DM, DM_distr, atomic_targets[i].nucleus, electron);
+			for(unsigned int j = 0; j < energies.size(); j++)
+				dRdE_atom[j] += dRdE_shell[j];
+		}
+		for(unsigned int j = 0; j < energies.size(); j++)
+			dRdE[j] += relative_mass_fractions[i] * dRdE_atom[j];
+	}
+	return dRdE;
+}
+
 double DM_Detector_Ionization::DM_Signals_Total(const DM_Particle& DM, DM_Distribution& DM_distr)
 {
 	double N = 0;
@@ -226,6 +244,14 @@ double DM_Detector_Ionization::dRdE_Ionization(double E, const DM_Particle& DM,
 	return dRdE;
 }
 
+std::vector<double> DM_Detector_Ionization::dRdE_Ionization_Batch(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& nucleus, Atomic_Electron& shell)
+{
+	std::vector<double> dRdE;
+	for(auto& E : energies)
+		dRdE.push_back(dRdE_Ionization(E, DM, DM_distr, nucleus, shell));
+	return dRdE;
+}
+
 // Electron spectrum
 
 double PDF_ne(unsigned int ne, double Ee, double W, int n_secondary)
@@ -239,11 +265,16 @@ double PDF_ne(unsigned int ne, double Ee, double W, int n_secondary)
 
 double DM_Detector_Ionization::R_ne(unsigned int ne, const DM_Particle& DM, DM_Distribution& DM_distr, double W, const Nucleus& nucleus, Atomic_Electron& shell)
 {
-	double R = 0.0;
-	for(auto& k : shell.k_Grid)
+	// In the coarse pass of progressive limit curves, only every n-th point of the momentum grid is used.
+	std::vector<double> energies;
+	for(unsigned int i = 0; i < shell.k_Grid.size(); i += spectrum_coarsening)
+		energies.push_back(shell.k_Grid[i] * shell.k_Grid[i] / 2.0 / mElectron);
+	std::vector<double> spectrum = dRdE_Ionization_Batch(energies, DM, DM_distr, nucleus, shell);
+	double R					 = 0.0;
+	for(unsigned int i = 0; i < energies.size(); i++)
 	{
-		double Ee = k * k / 2.0 / mElectron;
-		R += log(10.0) * shell.dlogk * k * k / mElectron * PDF_ne(ne, Ee, W, shell.number_of_secondary_electrons) * dRdE_Ionization(Ee, DM, DM_distr, nucleus, shell);
+		double k = shell.k_Grid[i * spectrum_coarsening];
+		R += log(10.0) * spectrum_coarsening * shell.dlogk * k * k / mElectron * PDF_ne(ne, energies[i], W, shell.number_of_secondary_electrons) * spectrum[i];
 	}
 	return R;
 }
@@ -13,10 +13,10 @@ namespace obscura
 using namespace libphysica::natural_units;
 
 //1. Theoretical nuclear recoil spectrum
-double dRdER_Nucleus(double ER, const DM_Particle& DM, DM_Distribution& DM_distr, const Isotope& target_isotope)
+//Spectrum of an isotope at one recoil energy for a given maximum DM speed, shared by the scalar and batch versions.
+static double dRdER_Isotope(double ER, const DM_Particle& DM, DM_Distribution& DM_distr, const Isotope& target_isotope, double vMax)
 {
 	double vMin = vMinimal_Nucleus(ER, DM.mass, target_isotope.mass);
-	double vMax = DM_distr.Maximum_DM_Speed();
 	if(vMin > vMax)
 		return 0.0;
 	else if(DM.DD_use_eta_function && DM_distr.DD_use_eta_function)
@@ -35,6 +35,11 @@ double dRdER_Nucleus(double ER, const DM_Particle& DM, DM_Distribution& DM_distr
 	}
 }
 
+double dRdER_Nucleus(double ER, const DM_Particle& DM, DM_Distribution& DM_distr, const Isotope& target_isotope)
+{
+	return dRdER_Isotope(ER, DM, DM_distr, target_isotope, DM_distr.Maximum_DM_Speed());
+}
+
 double dRdER_Nucleus(double ER, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& target_nucleus)
 {
 	double dRate = 0.0;
@@ -44,6 +49,27 @@ double dRdER_Nucleus(double ER, const DM_Particle& DM, DM_Distribution& DM_distr
 	return dRate;
 }
 
+std::vector<double> dRdER_Nucleus(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr, const Isotope& target_isotope)
+{
+	std::vector<double> dRates;
+	double vMax = DM_distr.Maximum_DM_Speed();
+	for(auto& ER : energies)
+		dRates.push_back(dRdER_Isotope(ER, DM, DM_distr, target_isotope, vMax));
+	return dRates;
+}
+
+std::vector<double> dRdER_Nucleus(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& target_nucleus)
+{
+	std::vector<double> dRates(energies.size(), 0.0);
+	for(unsigned int i = 0; i < target_nucleus.Number_of_Isotopes(); i++)
+	{
+		std::vector<double> dRates_isotope = dRdER_Nucleus(energies, DM, DM_distr, target_nucleus[i]);
+		for(unsigned int j = 0; j < energies.size(); j++)
+			dRates[j] += target_nucleus[i].abundance * dRates_isotope[j];
+	}
+	return dRates;
+}
+
 //2. Nuclear recoil direct detection experiment
 //Constructors
 DM_Detector_Nucleus::DM_Detector_Nucleus()
@@ -172,6 +198,31 @@ double DM_Detector_Nucleus::dRdE(double E, const DM_Particle& DM, DM_Distributio
 	return dR;
 }
 
+std::vector<double> DM_Detector_Nucleus::dRdE_Batch(const std::vector<double>& energies, const DM_Particle& DM, DM_Distribution& DM_distr)
+{
+	// With a finite resolution, every energy requires its own convolution.
+	if(energy_resolution >= 1e-6 * eV)
+		return DM_Detector::dRdE_Batch(energies, DM, DM_distr);
+	std::vector<double> dR(energies.size(), 0.0);
+	for(unsigned int i = 0; i < target_nuclei.size(); i++)
+	{
+		std::vector<double> dR_nucleus = dRdER_Nucleus(energies, DM, DM_distr, target_nuclei[i]);
+		for(unsigned int j = 0; j < energies.size(); j++)
+		{
+			double eff = 1.0;
+			if(using_efficiency_tables)
+			{
+				if(efficiencies.size() == 1)
+					eff = efficiencies[0](energies[j]);
+				else if(efficiencies.size() == target_nuclei.size())
+					eff = efficiencies[i](energies[j]);
+			}
+			dR[j] += eff * flat_efficiency * relative_mass_fractions[i] * dR_nucleus[j];
+		}
+	}
+	return dR;
+}
+
 double DM_Detector_Nucleus::Minimum_DM_Speed(DM_Particle& DM) const
 {
 	double Emin = energy_threshold - 2.0 * energy_resolution;
@@ -0,0 +1,385 @@
+#include "obscura/Global_Fit.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+#include "libphysica/Utilities.hpp"
+
+#include "obscura/Multithreading.hpp"
+
+namespace obscura
+{
+
+Fit_Parameter::Fit_Parameter(std::string parameter_name, double min, double max, bool log)
+: name(parameter_name), minimum(min), maximum(max), log_scale(log)
+{
+}
+
+const std::vector<std::string> fit_parameter_names = {"mDM", "coupling", "rho", "v0", "vesc", "vObserver", "eta", "beta"};
+
+Ensemble_Sampler::Ensemble_Sampler(const std::vector<Fit_Parameter>& fit_parameters, const DM_Particle& DM, const Standard_Halo_Model& halo, const std::vector<DM_Detector*>& detectors, unsigned int number_of_walkers, unsigned long int seed, double a, unsigned int coupling_moves_per_step)
+: parameters(fit_parameters), coupling_index(-1), targets(""), stretch_scale(a), coupling_moves(coupling_moves_per_step), walkers_evaluated(false), steps(0)
+{
+	if(parameters.empty() || detectors.empty())
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Ensemble_Sampler::Ensemble_Sampler(): A global fit needs at least one parameter and one detector." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	else if(number_of_walkers % 2 != 0 || number_of_walkers < 2 * parameters.size())
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Ensemble_Sampler::Ensemble_Sampler(): The number of walkers (" << number_of_walkers << ") has to be even and at least twice the number of parameters (" << parameters.size() << ")." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	else if(stretch_scale <= 1.0)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Ensemble_Sampler::Ensemble_Sampler(): The scale of the stretch move (" << stretch_scale << ") has to be larger than 1." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	for(unsigned int i = 0; i < parameters.size(); i++)
+	{
+		Fit_Parameter& parameter = parameters[i];
+		if(std::find(fit_parameter_names.begin(), fit_parameter_names.end(), parameter.name) == fit_parameter_names.end())
+		{
+			std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Ensemble_Sampler::Ensemble_Sampler(): Parameter " << parameter.name << " not recognized." << std::endl;
+			std::exit(EXIT_FAILURE);
+		}
+		else if(parameter.minimum >= parameter.maximum || (parameter.log_scale && parameter.minimum <= 0.0))
+		{
+			std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Ensemble_Sampler::Ensemble_Sampler(): The prior range [" << parameter.minimum << "," << parameter.maximum << "] of " << parameter.name << " is empty or not positive for a log scale." << std::endl;
+			std::exit(EXIT_FAILURE);
+		}
+		else if((parameter.name == "eta" || parameter.name == "beta") && dynamic_cast<const SHM_Plus_Plus*>(&halo) == nullptr)
+		{
+			std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Ensemble_Sampler::Ensemble_Sampler(): Parameter " << parameter.name << " requires the SHM++." << std::endl;
+			std::exit(EXIT_FAILURE);
+		}
+		for(unsigned int j = 0; j < i; j++)
+			if(parameters[j].name == parameter.name)
+			{
+				std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Ensemble_Sampler::Ensemble_Sampler(): Parameter " << parameter.name << " appears twice." << std::endl;
+				std::exit(EXIT_FAILURE);
+			}
+		if(parameter.name == "coupling")
+			coupling_index = i;
+		// The walkers move in log10 of parameters with a log scale.
+		if(parameter.log_scale)
+		{
+			parameter.minimum = log10(parameter.minimum);
+			parameter.maximum = log10(parameter.maximum);
+		}
+	}
+	targets = detectors[0]->Target_Particles();
+	for(auto& detector : detectors)
+		if(detector->Target_Particles() != targets)
+		{
+			std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Ensemble_Sampler::Ensemble_Sampler(): Target particles of " << detector->name << " (" << detector->Target_Particles() << ") differ from " << targets << "." << std::endl;
+			std::exit(EXIT_FAILURE);
+		}
+
+	for(unsigned int i = 0; i < number_of_walkers; i++)
+	{
+		Walker walker;
+		walker.log_posterior = -std::numeric_limits<double>::infinity();
+		walker.DM			 = std::unique_ptr<DM_Particle>(DM.Clone());
+		walker.halo			 = std::unique_ptr<Standard_Halo_Model>(halo.Clone());
+		walker.DM_proposal	 = std::unique_ptr<DM_Particle>(DM.Clone());
+		walker.halo_proposal = std::unique_ptr<Standard_Halo_Model>(halo.Clone());
+		for(auto& detector : detectors)
+		{
+			walker.detectors.push_back(std::unique_ptr<DM_Detector>(detector->Clone()));
+			walker.detectors_proposal.push_back(std::unique_ptr<DM_Detector>(detector->Clone()));
+		}
+		walker.generator		  = std::mt19937_64(seed + i);
+		walker.proposals		  = 0;
+		walker.accepted_proposals = 0;
+		walker.spectra			  = 0;
+		std::uniform_real_distribution<double> uniform(0.0, 1.0);
+		for(auto& parameter : parameters)
+			walker.position.push_back(parameter.minimum + uniform(walker.generator) * (parameter.maximum - parameter.minimum));
+		walkers.push_back(std::move(walker));
+	}
+}
+
+double Ensemble_Sampler::Parameter_Value(unsigned int i, double x) const
+{
+	return parameters[i].log_scale ? pow(10.0, x) : x;
+}
+
+void Ensemble_Sampler::Set_Parameters(DM_Particle& DM, Standard_Halo_Model& halo, const std::vector<double>& position) const
+{
+	// The mass is set first, since the interaction parameter may depend on it.
+	for(unsigned int i = 0; i < parameters.size(); i++)
+		if(parameters[i].name == "mDM")
+			DM.Set_Mass(Parameter_Value(i, position[i]));
+	for(unsigned int i = 0; i < parameters.size(); i++)
+	{
+		double value = Parameter_Value(i, position[i]);
+		if(parameters[i].name == "coupling")
+			DM.Set_Interaction_Parameter(value, targets);
+		else if(parameters[i].name == "rho")
+			halo.DM_density = value;
+		else if(parameters[i].name == "v0")
+			halo.Set_Speed_Dispersion(value);
+		else if(parameters[i].name == "vesc")
+			halo.Set_Escape_Velocity(value);
+		else if(parameters[i].name == "vObserver")
+			halo.Set_Observer_Velocity(halo.Get_Observer_Velocity().Normalized() * value);
+		else if(parameters[i].name == "eta")
+			dynamic_cast<SHM_Plus_Plus&>(halo).Set_Eta(value);
+		else if(parameters[i].name == "beta")
+			dynamic_cast<SHM_Plus_Plus&>(halo).Set_Beta(value);
+	}
+}
+
+bool Ensemble_Sampler::Within_Prior(const std::vector<double>& position) const
+{
+	for(unsigned int i = 0; i < parameters.size(); i++)
+		if(position[i] < parameters[i].minimum || position[i] > parameters[i].maximum)
+			return false;
+	return true;
+}
+
+double Ensemble_Sampler::Log_Likelihood(DM_Particle& DM, Standard_Halo_Model& halo, std::vector<std::unique_ptr<DM_Detector>>& detectors) const
+{
+	double log_likelihood = 0.0;
+	for(auto& detector : detectors)
+		log_likelihood += detector->Log_Likelihood(DM, halo);
+	return std::isnan(log_likelihood) ? -std::numeric_limits<double>::infinity() : log_likelihood;
+}
+
+void Ensemble_Sampler::Evaluate_Walker(Walker& walker)
+{
+	Set_Parameters(*walker.DM, *walker.halo, walker.position);
+	for(auto& detector : walker.detectors)
+	{
+		detector->Reset_Fiducial_Values();
+		detector->Set_Fiducial_Values(*walker.DM, *walker.halo);
+	}
+	walker.spectra += walker.detectors.size();
+	walker.log_posterior = Log_Likelihood(*walker.DM, *walker.halo, walker.detectors);
+}
+
+void Ensemble_Sampler::Initialize_Walkers(const std::vector<double>& position, double relative_width)
+{
+	if(position.size() != parameters.size())
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Ensemble_Sampler::Initialize_Walkers(): The position has " << position.size() << " instead of " << parameters.size() << " parameters." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	std::vector<double> center;
+	for(unsigned int i = 0; i < parameters.size(); i++)
+		center.push_back(parameters[i].log_scale ? log10(position[i]) : position[i]);
+	if(!Within_Prior(center))
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Ensemble_Sampler::Initialize_Walkers(): The position lies outside the prior ranges." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	for(auto& walker : walkers)
+	{
+		std::normal_distribution<double> normal(0.0, relative_width);
+		for(unsigned int i = 0; i < parameters.size(); i++)
+		{
+			double x		   = center[i] + normal(walker.generator) * (parameters[i].maximum - parameters[i].minimum);
+			walker.position[i] = std::min(std::max(x, parameters[i].minimum), parameters[i].maximum);
+		}
+	}
+	walkers_evaluated = false;
+}
+
+bool Ensemble_Sampler::Stretch_Move(unsigned int k, unsigned int first_partner, unsigned int partners, const std::vector<unsigned int>& dimensions)
+{
+	Walker& walker = walkers[k];
+	std::uniform_int_distribution<unsigned int> partner_distribution(first_partner, first_partner + partners - 1);
+	std::uniform_real_distribution<double> uniform(0.0, 1.0);
+	const std::vector<double>& partner = walkers[partner_distribution(walker.generator)].position;
+	// The stretch factor z follows g(z) ~ 1/sqrt(z) on [1/a, a].
+	double z					 = pow((stretch_scale - 1.0) * uniform(walker.generator) + 1.0, 2) / stretch_scale;
+	double u					 = uniform(walker.generator);
+	std::vector<double> proposal = walker.position;
+	for(auto& d : dimensions)
+		proposal[d] = partner[d] + z * (walker.position[d] - partner[d]);
+
+	bool coupling_only	 = (dimensions.size() == 1 && static_cast<int>(dimensions[0]) == coupling_index);
+	double log_posterior = -std::numeric_limits<double>::infinity();
+	if(Within_Prior(proposal))
+	{
+		if(coupling_only)
+		{
+			walker.DM->Set_Interaction_Parameter(Parameter_Value(coupling_index, proposal[coupling_index]), targets);
+			log_posterior = Log_Likelihood(*walker.DM, *walker.halo, walker.detectors);
+		}
+		else
+		{
+			Set_Parameters(*walker.DM_proposal, *walker.halo_proposal, proposal);
+			for(auto& detector : walker.detectors_proposal)
+			{
+				detector->Reset_Fiducial_Values();
+				detector->Set_Fiducial_Values(*walker.DM_proposal, *walker.halo_proposal);
+			}
+			walker.spectra += walker.detectors_proposal.size();
+			log_posterior = Log_Likelihood(*walker.DM_proposal, *walker.halo_proposal, walker.detectors_proposal);
+		}
+	}
+	walker.proposals++;
+
+	bool accepted = log(u) < (dimensions.size() - 1.0) * log(z) + log_posterior - walker.log_posterior;
+	if(accepted)
+	{
+		walker.position		 = proposal;
+		walker.log_posterior = log_posterior;
+		walker.accepted_proposals++;
+		if(!coupling_only)
+		{
+			std::swap(walker.DM, walker.DM_proposal);
+			std::swap(walker.halo, walker.halo_proposal);
+			std::swap(walker.detectors, walker.detectors_proposal);
+		}
+	}
+	else if(coupling_only)
+		walker.DM->Set_Interaction_Parameter(Parameter_Value(coupling_index, walker.position[coupling_index]), targets);
+	return accepted;
+}
+
+void Ensemble_Sampler::Sweep(const std::vector<unsigned int>& dimensions, unsigned int threads)
+{
+	unsigned int half = walkers.size() / 2;
+	for(unsigned int h = 0; h < 2; h++)
+		Parallel_For(half, threads, [this, &dimensions, h, half](unsigned int i, unsigned int worker) {
+			Stretch_Move(h * half + i, (1 - h) * half, half, dimensions);
+		});
+}
+
+void Ensemble_Sampler::Run(unsigned int number_of_steps, const std::string& chain_file, unsigned int threads)
+{
+	std::ofstream f;
+	if(!chain_file.empty())
+	{
+		// A new chain starts a new file, later runs are appended.
+		f.open(chain_file, (steps == 0) ? std::ios::trunc : std::ios::app);
+		if(!f)
+		{
+			std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Ensemble_Sampler::Run(): File " << chain_file << " could not be opened." << std::endl;
+			std::exit(EXIT_FAILURE);
+		}
+		f << std::setprecision(10);
+		if(steps == 0)
+		{
+			f << "# step\twalker";
+			for(auto& parameter : parameters)
+				f << "\t" << parameter.name;
+			f << "\tlog_posterior" << std::endl;
+		}
+	}
+	if(!walkers_evaluated)
+	{
+		Parallel_For(walkers.size(), threads, [this](unsigned int i, unsigned int worker) {
+			Evaluate_Walker(walkers[i]);
+		});
+		walkers_evaluated = true;
+	}
+
+	std::vector<unsigned int> all_dimensions(parameters.size());
+	for(unsigned int d = 0; d < parameters.size(); d++)
+		all_dimensions[d] = d;
+	for(unsigned int step = 0; step < number_of_steps; step++)
+	{
+		Sweep(all_dimensions, threads);
+		if(coupling_index >= 0 && parameters.size() > 1)
+			for(unsigned int move = 0; move < coupling_moves; move++)
+				Sweep({static_cast<unsigned int>(coupling_index)}, threads);
+		for(unsigned int i = 0; i < walkers.size(); i++)
+		{
+			std::vector<double> entry = {1.0 * steps, 1.0 * i};
+			for(unsigned int d = 0; d < parameters.size(); d++)
+				entry.push_back(Parameter_Value(d, walkers[i].position[d]));
+			entry.push_back(walkers[i].log_posterior);
+			chain.push_back(entry);
+			if(f.is_open())
+			{
+				for(unsigned int j = 0; j < entry.size(); j++)
+					f << ((j == 0) ? "" : "\t") << entry[j];
+				f << std::endl;
+			}
+		}
+		steps++;
+	}
+	if(f.is_open())
+		f.close();
+}
+
+unsigned int Ensemble_Sampler::Number_of_Walkers() const
+{
+	return walkers.size();
+}
+
+unsigned long int Ensemble_Sampler::Number_of_Steps() const
+{
+	return steps;
+}
+
+double Ensemble_Sampler::Acceptance_Fraction() const
+{
+	unsigned long int proposals = 0, accepted_proposals = 0;
+	for(auto& walker : walkers)
+	{
+		proposals += walker.proposals;
+		accepted_proposals += walker.accepted_proposals;
+	}
+	return (proposals == 0) ? 0.0 : 1.0 * accepted_proposals / proposals;
+}
+
+unsigned long int Ensemble_Sampler::Number_of_Spectra() const
+{
+	unsigned long int spectra = 0;
+	for(auto& walker : walkers)
+		spectra += walker.spectra;
+	return spectra;
+}
+
+std::vector<std::vector<double>> Ensemble_Sampler::Chain(unsigned int burn_in) const
+{
+	std::vector<std::vector<double>> samples;
+	for(auto& entry : chain)
+		if(entry[0] >= burn_in)
+			samples.push_back(entry);
+	return samples;
+}
+
+std::vector<double> Ensemble_Sampler::Best_Fit() const
+{
+	std::vector<double> best_fit;
+	double log_posterior_max = -std::numeric_limits<double>::infinity();
+	for(auto& entry : chain)
+		if(entry.back() > log_posterior_max)
+		{
+			log_posterior_max = entry.back();
+			best_fit		  = std::vector<double>(entry.begin() + 2, entry.end() - 1);
+		}
+	return best_fit;
+}
+
+void Ensemble_Sampler::Print_Summary(int MPI_rank) const
+{
+	if(MPI_rank == 0)
+	{
+		std::cout << std::endl
+				  << "----------------------------------------" << std::endl
+				  << "Ensemble sampler summary:" << std::endl
+				  << "\tTarget particles:\t" << targets << std::endl
+				  << "\tWalkers:\t" << walkers.size() << std::endl
+				  << "\tParameters:\t" << parameters.size() << std::endl;
+		for(auto& parameter : parameters)
+			std::cout << "\t\t" << parameter.name << "\t[" << (parameter.log_scale ? pow(10.0, parameter.minimum) : parameter.minimum) << "," << (parameter.log_scale ? pow(10.0, parameter.maximum) : parameter.maximum) << "]" << (parameter.log_scale ? " (log prior)" : "") << std::endl;
+		std::cout << "\tSteps:\t" << steps << std::endl
+				  << "\tAcceptance fraction:\t" << libphysica::Round(Acceptance_Fraction()) << std::endl
+				  << "\tComputed spectra:\t" << Number_of_Spectra() << std::endl
+				  << "----------------------------------------" << std::endl
+				  << std::endl;
+	}
+}
+
+}	// namespace obscura
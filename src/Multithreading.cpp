@@ -0,0 +1,42 @@
+#include "obscura/Multithreading.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace obscura
+{
+
+unsigned int Number_of_Threads(unsigned int threads)
+{
+	if(threads == 0)
+		threads = std::thread::hardware_concurrency();
+	return (threads == 0) ? 1 : threads;
+}
+
+void Parallel_For(unsigned int tasks, unsigned int threads, const std::function<void(unsigned int, unsigned int)>& task)
+{
+	unsigned int workers = std::min(Number_of_Threads(threads), tasks);
+	if(workers <= 1)
+	{
+		for(unsigned int i = 0; i < tasks; i++)
+			task(i, 0);
+	}
+	else
+	{
+		std::atomic<unsigned int> next_task(0);
+		auto worker = [&next_task, tasks, &task](unsigned int worker_index) {
+			for(unsigned int i = next_task++; i < tasks; i = next_task++)
+				task(i, worker_index);
+		};
+		std::vector<std::thread> threads_pool;
+		for(unsigned int w = 1; w < workers; w++)
+			threads_pool.push_back(std::thread(worker, w));
+		worker(0);
+		for(auto& thread : threads_pool)
+			thread.join();
+	}
+}
+
+}	// namespace obscura
@@ -0,0 +1,838 @@
+#include "obscura/Statistical_Methods.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+
+#include "libphysica/Numerics.hpp"
+#include "libphysica/Utilities.hpp"
+
+#include "obscura/Multithreading.hpp"
+
+#include "version.hpp"
+
+namespace obscura
+{
+
+// Tables cached in the data directory are exported to a temporary file, which is then renamed, such that concurrent processes never read a partially written table.
+// If the data directory is not writable, the table is only kept in memory.
+template <class Table>
+static void Export_Cached_Table(const Table& table, const std::string& filename)
+{
+	std::string temporary_filename = filename + ".tmp" + std::to_string(std::random_device()());
+	bool writable				   = std::ofstream(temporary_filename).is_open();
+	if(writable)
+	{
+		table.Export(temporary_filename);
+		writable = (std::rename(temporary_filename.c_str(), filename.c_str()) == 0);
+	}
+	if(!writable)
+	{
+		std::remove(temporary_filename.c_str());
+		std::cerr << libphysica::Formatted_String("Warning", "Yellow", true) << " in obscura::Export_Cached_Table(): File " << filename << " could not be written. The table is kept in memory only." << std::endl;
+	}
+}
+
+// 1. Maximum gap method a'la Yellin
+double CDF_Maximum_Gap(double x, double mu)
+{
+	if(x <= 0.0)
+		return 0.0;
+	else if(x == mu)
+		return 1.0 - exp(-mu);
+	else if(x > mu)
+		return 1.0;
+
+	// Terms (kx-mu)^k / k! * exp(-kx) * (1 + k/(mu-kx)) = (-1)^k (mu-kx)^(k-1) (mu-kx+k) / k! * exp(-kx), summed with Neumaier's algorithm in extended precision.
+	unsigned int m			   = mu / x;
+	long double sum			   = 1.0;
+	long double compensation   = 0.0;
+	long double rounding_error = 0.0;
+	for(unsigned int k = 1; k <= m; k++)
+	{
+		double base = mu - k * x;
+		double term, log_magnitude;
+		if(k == 1)
+		{
+			term		  = -(base + 1.0) * exp(-x);
+			log_magnitude = x;
+		}
+		else if(base <= 0.0)
+			continue;
+		else
+		{
+			double log_term = (k - 1) * log(base) + log(base + k) - k * x - std::lgamma(k + 1.0);
+			term			= (k % 2 == 0) ? exp(log_term) : -exp(log_term);
+			log_magnitude	= (k - 1) * std::fabs(log(base)) + k * x + std::lgamma(k + 1.0);
+		}
+		long double new_sum = sum + term;
+		if(fabsl(sum) >= std::fabs(term))
+			compensation += (sum - new_sum) + term;
+		else
+			compensation += (term - new_sum) + sum;
+		sum = new_sum;
+		rounding_error += std::fabs(term) * (1.0 + log_magnitude) * DBL_EPSILON;
+	}
+
+	// If the cancellations are too severe, we use the asymptotic distribution for large mu, where the number of gaps larger than x is Poisson distributed.
+	if(rounding_error > 1.0e-8)
+		return exp(-(1.0 + mu - x) * exp(-x));
+
+	double cdf = sum + compensation;
+	if(cdf < 0.0)
+		return 0.0;
+	else if(cdf > 1.0)
+		return 1.0;
+	else
+		return cdf;
+}
+
+// The CDF is tabulated as z = ln(-ln C_0) in terms of log10(mu) and w = x - ln(1+mu).
+// For large mu, C_0 approaches exp(-(1+mu-x) exp(-x)), such that z becomes almost linear in w and independent of mu.
+double CDF_Maximum_Gap_Table::Gap(double log10_mu, double w) const
+{
+	return w + log1p(pow(10.0, log10_mu));
+}
+
+CDF_Maximum_Gap_Table::CDF_Maximum_Gap_Table(double mu_min, double mu_max, unsigned int N_mu, double wmin, double wmax, unsigned int N_w, double tol, unsigned int threads)
+: log10_mu_min(log10(mu_min)), log10_mu_max(log10(mu_max)), w_min(wmin), w_max(wmax), tolerance(tol), mu_points(N_mu), w_points(N_w), table(N_mu, std::vector<double>(N_w, 0.0)), accurate_cells(N_mu - 1, std::vector<bool>(N_w - 1, false))
+{
+	if(mu_min <= 0.0 || mu_max <= mu_min || w_max <= w_min || N_mu < 2 || N_w < 2)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::CDF_Maximum_Gap_Table::CDF_Maximum_Gap_Table(): Invalid grid with mu in [" << mu_min << "," << mu_max << "], w in [" << w_min << "," << w_max << "], and " << N_mu << "x" << N_w << " points." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	delta_log10_mu = (log10_mu_max - log10_mu_min) / (mu_points - 1);
+	delta_w		   = (w_max - w_min) / (w_points - 1);
+
+	Parallel_For(mu_points, threads, [this](unsigned int i, unsigned int worker) {
+		double log10_mu = log10_mu_min + i * delta_log10_mu;
+		double mu		= pow(10.0, log10_mu);
+		for(unsigned int j = 0; j < w_points; j++)
+		{
+			double x	= Gap(log10_mu, w_min + j * delta_w);
+			table[i][j] = (x > 0.0 && x < mu) ? log(-log(CDF_Maximum_Gap(x, mu))) : NAN;
+		}
+	});
+	Check_Interpolation_Error(threads);
+}
+
+CDF_Maximum_Gap_Table::CDF_Maximum_Gap_Table(const std::string& filename)
+{
+	std::ifstream f;
+	f.open(filename);
+	if(!f)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::CDF_Maximum_Gap_Table::CDF_Maximum_Gap_Table(): File " << filename << " not found." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	f >> log10_mu_min >> log10_mu_max >> mu_points >> w_min >> w_max >> w_points >> tolerance;
+	if(!f || mu_points < 2 || w_points < 2)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::CDF_Maximum_Gap_Table::CDF_Maximum_Gap_Table(): File " << filename << " is not a valid table." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	delta_log10_mu = (log10_mu_max - log10_mu_min) / (mu_points - 1);
+	delta_w		   = (w_max - w_min) / (w_points - 1);
+	table		   = std::vector<std::vector<double>>(mu_points, std::vector<double>(w_points, 0.0));
+	accurate_cells = std::vector<std::vector<bool>>(mu_points - 1, std::vector<bool>(w_points - 1, false));
+	for(auto& row : table)
+		for(auto& entry : row)
+		{
+			std::string value;
+			f >> value;
+			entry = std::strtod(value.c_str(), nullptr);
+		}
+	for(unsigned int i = 0; i < mu_points - 1; i++)
+		for(unsigned int j = 0; j < w_points - 1; j++)
+		{
+			int accurate = 0;
+			f >> accurate;
+			accurate_cells[i][j] = (accurate == 1);
+		}
+	if(!f)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::CDF_Maximum_Gap_Table::CDF_Maximum_Gap_Table(): File " << filename << " is not a valid table." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	f.close();
+}
+
+double CDF_Maximum_Gap_Table::Interpolate(unsigned int i, unsigned int j, double log10_mu, double w) const
+{
+	double t = (log10_mu - log10_mu_min) / delta_log10_mu - i;
+	double u = (w - w_min) / delta_w - j;
+	double z = (1.0 - t) * (1.0 - u) * table[i][j] + t * (1.0 - u) * table[i + 1][j] + (1.0 - t) * u * table[i][j + 1] + t * u * table[i + 1][j + 1];
+	return exp(-exp(z));
+}
+
+void CDF_Maximum_Gap_Table::Check_Interpolation_Error(unsigned int threads)
+{
+	// Compare the interpolation with the direct evaluation on a 4x4 grid of test points within each cell.
+	unsigned int test_points = 4;
+	Parallel_For(mu_points - 1, threads, [this, test_points](unsigned int i, unsigned int worker) {
+		for(unsigned int j = 0; j < w_points - 1; j++)
+		{
+			accurate_cells[i][j] = std::isfinite(table[i][j]) && std::isfinite(table[i + 1][j]) && std::isfinite(table[i][j + 1]) && std::isfinite(table[i + 1][j + 1]);
+			for(unsigned int k = 0; k < test_points * test_points && accurate_cells[i][j]; k++)
+			{
+				double log10_mu = log10_mu_min + (i + (k / test_points + 0.5) / test_points) * delta_log10_mu;
+				double w		= w_min + (j + (k % test_points + 0.5) / test_points) * delta_w;
+				double error	= std::fabs(Interpolate(i, j, log10_mu, w) - CDF_Maximum_Gap(Gap(log10_mu, w), pow(10.0, log10_mu)));
+				if(!(error < tolerance))
+					accurate_cells[i][j] = false;
+			}
+		}
+	});
+}
+
+double CDF_Maximum_Gap_Table::operator()(double x, double mu) const
+{
+	if(mu <= 0.0 || x <= 0.0 || x >= mu)
+		return CDF_Maximum_Gap(x, mu);
+	double log10_mu = log10(mu);
+	double w		= x - log1p(mu);
+	if(log10_mu < log10_mu_min || log10_mu >= log10_mu_max || w < w_min || w >= w_max)
+		return CDF_Maximum_Gap(x, mu);
+	unsigned int i = std::min(static_cast<unsigned int>((log10_mu - log10_mu_min) / delta_log10_mu), mu_points - 2);
+	unsigned int j = std::min(static_cast<unsigned int>((w - w_min) / delta_w), w_points - 2);
+	if(accurate_cells[i][j])
+		return Interpolate(i, j, log10_mu, w);
+	else
+		return CDF_Maximum_Gap(x, mu);
+}
+
+double CDF_Maximum_Gap_Table::Fraction_of_Accurate_Cells() const
+{
+	unsigned int accurate = 0;
+	for(auto& row : accurate_cells)
+		for(bool cell : row)
+			accurate += cell;
+	return 1.0 * accurate / (mu_points - 1) / (w_points - 1);
+}
+
+void CDF_Maximum_Gap_Table::Export(const std::string& filename) const
+{
+	std::ofstream f;
+	f.open(filename);
+	if(!f)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::CDF_Maximum_Gap_Table::Export(): File " << filename << " could not be opened." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	f << std::setprecision(17) << log10_mu_min << "\t" << log10_mu_max << "\t" << mu_points << "\t" << w_min << "\t" << w_max << "\t" << w_points << "\t" << tolerance << std::endl;
+	for(auto& row : table)
+	{
+		for(unsigned int j = 0; j < row.size(); j++)
+			f << ((j == 0) ? "" : "\t") << row[j];
+		f << std::endl;
+	}
+	for(auto& row : accurate_cells)
+	{
+		for(unsigned int j = 0; j < row.size(); j++)
+			f << ((j == 0) ? "" : "\t") << row[j];
+		f << std::endl;
+	}
+	f.close();
+}
+
+static CDF_Maximum_Gap_Table Cached_CDF_Maximum_Gap_Table()
+{
+	std::string filename = PROJECT_DIR "data/CDF_Maximum_Gap_Table.txt";
+	if(libphysica::File_Exists(filename))
+		return CDF_Maximum_Gap_Table(filename);
+	else
+	{
+		// A single thread suffices, and the table may be generated from within a worker thread.
+		CDF_Maximum_Gap_Table table(0.01, 1000.0, 251, -5.0, 20.0, 201, 1.0e-6, 1);
+		Export_Cached_Table(table, filename);
+		return table;
+	}
+}
+
+double CDF_Maximum_Gap_Tabulated(double x, double mu)
+{
+	static const CDF_Maximum_Gap_Table table = Cached_CDF_Maximum_Gap_Table();
+	return table(x, mu);
+}
+
+double P_Value_Maximum_Gap(const std::vector<double>& gaps)
+{
+	double max_gap = *std::max_element(gaps.begin(), gaps.end());
+	double mu	   = std::accumulate(gaps.begin(), gaps.end(), 0.0);
+	return 1.0 - CDF_Maximum_Gap_Tabulated(max_gap, mu);
+}
+
+// 2. Optimum interval method a'la Yellin
+std::vector<double> Optimum_Interval_Fractions(const std::vector<double>& gaps, unsigned int n_max)
+{
+	std::vector<double> cumulative_signals(gaps.size() + 1, 0.0);
+	std::partial_sum(gaps.begin(), gaps.end(), cumulative_signals.begin() + 1);
+	double total_signals = cumulative_signals.back();
+
+	std::vector<double> fractions(n_max + 1, 1.0);
+	unsigned int events = gaps.empty() ? 0 : gaps.size() - 1;
+	for(unsigned int n = 0; n <= n_max && n < events && total_signals > 0.0; n++)
+	{
+		double maximum_interval = 0.0;
+		for(unsigned int i = 0; i + n + 1 < cumulative_signals.size(); i++)
+			maximum_interval = std::max(maximum_interval, cumulative_signals[i + n + 1] - cumulative_signals[i]);
+		fractions[n] = maximum_interval / total_signals;
+	}
+	return fractions;
+}
+
+// Empirical CDF P(X < value) reconstructed from the quantiles of X at probabilities k/(N-1).
+static double CDF_From_Quantiles(const std::vector<double>& quantiles, double value)
+{
+	auto upper = std::lower_bound(quantiles.begin(), quantiles.end(), value);
+	if(upper == quantiles.begin())
+		return 0.0;
+	else if(upper == quantiles.end())
+		return 1.0;
+	unsigned int k = std::distance(quantiles.begin(), upper) - 1;
+	return (k + (value - quantiles[k]) / (quantiles[k + 1] - quantiles[k])) / (quantiles.size() - 1);
+}
+
+static std::vector<double> Quantiles(const std::vector<double>& sorted_samples, unsigned int N)
+{
+	std::vector<double> quantiles;
+	for(unsigned int k = 0; k < N; k++)
+		quantiles.push_back(sorted_samples[std::round(1.0 * k / (N - 1) * (sorted_samples.size() - 1))]);
+	return quantiles;
+}
+
+Optimum_Interval_Table::Optimum_Interval_Table(double mu_min, double mu_max, unsigned int N_mu, unsigned int n_maximum, unsigned int N_toys, unsigned long int random_seed, unsigned int threads)
+: log10_mu_min(log10(mu_min)), log10_mu_max(log10(mu_max)), mu_points(N_mu), n_max(n_maximum), toys(N_toys), quantiles_intervals(101), quantiles_C_max(501), seed(random_seed), interval_quantiles(N_mu), C_max_quantiles(N_mu)
+{
+	if(mu_min <= 0.0 || mu_max <= mu_min || N_mu < 2 || N_toys < 2)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Optimum_Interval_Table::Optimum_Interval_Table(): Invalid grid with mu in [" << mu_min << "," << mu_max << "], " << N_mu << " grid points, and " << N_toys << " toys." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	delta_log10_mu = (log10_mu_max - log10_mu_min) / (mu_points - 1);
+	Parallel_For(mu_points, threads, [this](unsigned int i, unsigned int worker) {
+		Generate_Grid_Point(i);
+	});
+}
+
+Optimum_Interval_Table::Optimum_Interval_Table(const std::string& filename)
+{
+	std::ifstream f;
+	f.open(filename);
+	if(!f)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Optimum_Interval_Table::Optimum_Interval_Table(): File " << filename << " not found." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	f >> log10_mu_min >> log10_mu_max >> mu_points >> n_max >> toys >> quantiles_intervals >> quantiles_C_max >> seed;
+	if(!f || mu_points < 2)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Optimum_Interval_Table::Optimum_Interval_Table(): File " << filename << " is not a valid table." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	delta_log10_mu	   = (log10_mu_max - log10_mu_min) / (mu_points - 1);
+	interval_quantiles = std::vector<std::vector<std::vector<double>>>(mu_points, std::vector<std::vector<double>>(n_max + 1, std::vector<double>(quantiles_intervals, 0.0)));
+	C_max_quantiles	   = std::vector<std::vector<double>>(mu_points, std::vector<double>(quantiles_C_max, 0.0));
+	for(unsigned int i = 0; i < mu_points; i++)
+	{
+		for(auto& row : interval_quantiles[i])
+			for(auto& entry : row)
+				f >> entry;
+		for(auto& entry : C_max_quantiles[i])
+			f >> entry;
+	}
+	if(!f)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Optimum_Interval_Table::Optimum_Interval_Table(): File " << filename << " is not a valid table." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	f.close();
+}
+
+void Optimum_Interval_Table::Generate_Grid_Point(unsigned int i)
+{
+	// Each grid point has its own random number stream, such that the table does not depend on the number of threads.
+	std::mt19937_64 generator(seed + i);
+	double mu = pow(10.0, log10_mu_min + i * delta_log10_mu);
+	std::poisson_distribution<unsigned int> poisson_distribution(mu);
+	std::uniform_real_distribution<double> uniform_distribution(0.0, 1.0);
+
+	// 1. Largest intervals with at most n events for uniformly distributed events.
+	std::vector<std::vector<double>> toy_fractions(toys);
+	std::vector<std::vector<double>> interval_samples(n_max + 1, std::vector<double>(toys, 0.0));
+	for(unsigned int t = 0; t < toys; t++)
+	{
+		std::vector<double> events = {0.0, 1.0};
+		unsigned int N			   = poisson_distribution(generator);
+		for(unsigned int j = 0; j < N; j++)
+			events.push_back(uniform_distribution(generator));
+		std::sort(events.begin(), events.end());
+		std::vector<double> gaps;
+		for(unsigned int j = 0; j < events.size() - 1; j++)
+			gaps.push_back(events[j + 1] - events[j]);
+		toy_fractions[t] = Optimum_Interval_Fractions(gaps, n_max);
+		for(unsigned int n = 0; n <= n_max; n++)
+			interval_samples[n][t] = toy_fractions[t][n];
+	}
+	for(auto& samples : interval_samples)
+		std::sort(samples.begin(), samples.end());
+
+	// 2. Distribution of C_max = max_n C_n(x_n, mu)
+	std::vector<double> C_max_samples(toys, 0.0);
+	for(unsigned int t = 0; t < toys; t++)
+		for(unsigned int n = 0; n <= n_max; n++)
+		{
+			double C_n		 = 1.0 * std::distance(interval_samples[n].begin(), std::lower_bound(interval_samples[n].begin(), interval_samples[n].end(), toy_fractions[t][n])) / toys;
+			C_max_samples[t] = std::max(C_max_samples[t], C_n);
+		}
+	std::sort(C_max_samples.begin(), C_max_samples.end());
+
+	for(auto& samples : interval_samples)
+		interval_quantiles[i].push_back(Quantiles(samples, quantiles_intervals));
+	C_max_quantiles[i] = Quantiles(C_max_samples, quantiles_C_max);
+}
+
+double Optimum_Interval_Table::P_Value_Grid_Point(unsigned int i, const std::vector<double>& fractions) const
+{
+	double C_max = 0.0;
+	for(unsigned int n = 0; n <= n_max && n < fractions.size(); n++)
+		C_max = std::max(C_max, CDF_From_Quantiles(interval_quantiles[i][n], fractions[n]));
+	return 1.0 - CDF_From_Quantiles(C_max_quantiles[i], C_max);
+}
+
+double Optimum_Interval_Table::Minimum_Mu() const
+{
+	return pow(10.0, log10_mu_min);
+}
+
+double Optimum_Interval_Table::Maximum_Mu() const
+{
+	return pow(10.0, log10_mu_max);
+}
+
+unsigned int Optimum_Interval_Table::Maximum_Events() const
+{
+	return n_max;
+}
+
+double Optimum_Interval_Table::C_Max(const std::vector<double>& fractions, double mu) const
+{
+	double log10_mu = log10(mu);
+	if(log10_mu < log10_mu_min || log10_mu > log10_mu_max)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Optimum_Interval_Table::C_Max(): mu = " << mu << " lies outside the tabulated range [" << Minimum_Mu() << "," << Maximum_Mu() << "]." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	unsigned int i = std::min(static_cast<unsigned int>((log10_mu - log10_mu_min) / delta_log10_mu), mu_points - 2);
+	double t	   = (log10_mu - log10_mu_min) / delta_log10_mu - i;
+	double C_max   = 0.0;
+	for(unsigned int n = 0; n <= n_max && n < fractions.size(); n++)
+		C_max = std::max(C_max, (1.0 - t) * CDF_From_Quantiles(interval_quantiles[i][n], fractions[n]) + t * CDF_From_Quantiles(interval_quantiles[i + 1][n], fractions[n]));
+	return C_max;
+}
+
+double Optimum_Interval_Table::P_Value(const std::vector<double>& fractions, double mu) const
+{
+	double log10_mu = log10(mu);
+	if(log10_mu < log10_mu_min || log10_mu > log10_mu_max)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Optimum_Interval_Table::P_Value(): mu = " << mu << " lies outside the tabulated range [" << Minimum_Mu() << "," << Maximum_Mu() << "]." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	unsigned int i = std::min(static_cast<unsigned int>((log10_mu - log10_mu_min) / delta_log10_mu), mu_points - 2);
+	double t	   = (log10_mu - log10_mu_min) / delta_log10_mu - i;
+	return (1.0 - t) * P_Value_Grid_Point(i, fractions) + t * P_Value_Grid_Point(i + 1, fractions);
+}
+
+void Optimum_Interval_Table::Export(const std::string& filename) const
+{
+	std::ofstream f;
+	f.open(filename);
+	if(!f)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Optimum_Interval_Table::Export(): File " << filename << " could not be opened." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	f << std::setprecision(17) << log10_mu_min << "\t" << log10_mu_max << "\t" << mu_points << "\t" << n_max << "\t" << toys << "\t" << quantiles_intervals << "\t" << quantiles_C_max << "\t" << seed << std::endl
+	  << std::setprecision(10);
+	for(unsigned int i = 0; i < mu_points; i++)
+	{
+		for(auto& row : interval_quantiles[i])
+		{
+			for(unsigned int k = 0; k < row.size(); k++)
+				f << ((k == 0) ? "" : "\t") << row[k];
+			f << std::endl;
+		}
+		for(unsigned int k = 0; k < C_max_quantiles[i].size(); k++)
+			f << ((k == 0) ? "" : "\t") << C_max_quantiles[i][k];
+		f << std::endl;
+	}
+	f.close();
+}
+
+static Optimum_Interval_Table Cached_Optimum_Interval_Table()
+{
+	std::string filename = PROJECT_DIR "data/Optimum_Interval_Table.txt";
+	if(libphysica::File_Exists(filename))
+		return Optimum_Interval_Table(filename);
+	else
+	{
+		// The table is generated with all hardware threads, even if the first call comes from within a worker thread, since the other workers wait for the static table meanwhile.
+		Optimum_Interval_Table table(0.1, 1000.0, 61, 50, 5000, 42, Number_of_Threads(0));
+		Export_Cached_Table(table, filename);
+		return table;
+	}
+}
+
+double P_Value_Optimum_Interval(const std::vector<double>& gaps)
+{
+	static const Optimum_Interval_Table table = Cached_Optimum_Interval_Table();
+	double mu								  = std::accumulate(gaps.begin(), gaps.end(), 0.0);
+	if(mu < table.Minimum_Mu() || mu > table.Maximum_Mu())
+		return P_Value_Maximum_Gap(gaps);
+	else
+		return table.P_Value(Optimum_Interval_Fractions(gaps, table.Maximum_Events()), mu);
+}
+
+// 3. Feldman-Cousins confidence belts
+static double Log_PMF_Poisson(unsigned long int n, double lambda)
+{
+	if(lambda <= 0.0)
+		return (n == 0) ? 0.0 : -DBL_MAX;
+	return n * log(lambda) - lambda - std::lgamma(n + 1.0);
+}
+
+// Event numbers are ranked by their likelihood ratio w.r.t. the best fit mu = max(0, n-b), with ties broken towards fewer events.
+static double Feldman_Cousins_Ratio(unsigned long int n, double mu, double b)
+{
+	return Log_PMF_Poisson(n, mu + b) - Log_PMF_Poisson(n, std::max(b, 1.0 * n));
+}
+
+static bool Feldman_Cousins_Ranked_Before(const std::pair<double, unsigned long int>& a, const std::pair<double, unsigned long int>& b)
+{
+	return (a.first > b.first) || (a.first == b.first && a.second < b.second);
+}
+
+Feldman_Cousins_Belt::Feldman_Cousins_Belt(double b, double CL, unsigned int n_maximum, double mu_step, unsigned int threads)
+: background(b), certainty(CL), delta_mu(mu_step), n_max(n_maximum)
+{
+	if(background < 0.0 || certainty <= 0.0 || certainty >= 1.0 || delta_mu <= 0.0)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Feldman_Cousins_Belt::Feldman_Cousins_Belt(): Invalid belt with b = " << background << ", CL = " << certainty << ", and a step size of " << delta_mu << "." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	// The belt has to extend beyond the upper limit for n_max observed events.
+	double mu_max  = n_max + 6.0 * sqrt(n_max + 1.0) + 10.0;
+	mu_points	   = std::ceil(mu_max / delta_mu) + 1;
+	acceptance_min = std::vector<unsigned long int>(mu_points, 0);
+	acceptance_max = std::vector<unsigned long int>(mu_points, 0);
+	Parallel_For(mu_points, threads, [this](unsigned int i, unsigned int worker) {
+		Acceptance_Region(i);
+	});
+}
+
+Feldman_Cousins_Belt::Feldman_Cousins_Belt(const std::string& filename)
+{
+	std::ifstream f;
+	f.open(filename);
+	if(!f)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Feldman_Cousins_Belt::Feldman_Cousins_Belt(): File " << filename << " not found." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	f >> background >> certainty >> delta_mu >> n_max >> mu_points;
+	acceptance_min = std::vector<unsigned long int>(mu_points, 0);
+	acceptance_max = std::vector<unsigned long int>(mu_points, 0);
+	for(unsigned int i = 0; i < mu_points; i++)
+		f >> acceptance_min[i] >> acceptance_max[i];
+	if(!f || mu_points < 2)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Feldman_Cousins_Belt::Feldman_Cousins_Belt(): File " << filename << " is not a valid belt." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	f.close();
+}
+
+void Feldman_Cousins_Belt::Acceptance_Region(unsigned int i)
+{
+	// Order the event numbers by their likelihood ratio, and accept them until the probability content reaches the certainty level.
+	double mu				 = i * delta_mu;
+	double lambda			 = mu + background;
+	unsigned long int n_last = lambda + 10.0 * sqrt(lambda) + 20;
+	std::vector<std::pair<double, unsigned long int>> ranking;
+	for(unsigned long int n = 0; n <= n_last; n++)
+		ranking.push_back(std::make_pair(Feldman_Cousins_Ratio(n, mu, background), n));
+	std::sort(ranking.begin(), ranking.end(), Feldman_Cousins_Ranked_Before);
+	double probability = 0.0;
+	acceptance_min[i]  = ranking.front().second;
+	acceptance_max[i]  = ranking.front().second;
+	for(auto& entry : ranking)
+	{
+		acceptance_min[i] = std::min(acceptance_min[i], entry.second);
+		acceptance_max[i] = std::max(acceptance_max[i], entry.second);
+		probability += exp(Log_PMF_Poisson(entry.second, lambda));
+		if(probability >= certainty)
+			break;
+	}
+}
+
+double Feldman_Cousins_Belt::Background() const
+{
+	return background;
+}
+
+double Feldman_Cousins_Belt::Certainty_Level() const
+{
+	return certainty;
+}
+
+unsigned int Feldman_Cousins_Belt::Maximum_Events() const
+{
+	return n_max;
+}
+
+double Feldman_Cousins_Belt::Lower_Limit(unsigned long int n) const
+{
+	if(n > n_max)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Feldman_Cousins_Belt::Lower_Limit(): n = " << n << " exceeds the belt's maximum of " << n_max << " events." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	unsigned int i = 0;
+	while(acceptance_max[i] < n)
+		i++;
+	return i * delta_mu;
+}
+
+double Feldman_Cousins_Belt::Upper_Limit(unsigned long int n) const
+{
+	if(n > n_max)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Feldman_Cousins_Belt::Upper_Limit(): n = " << n << " exceeds the belt's maximum of " << n_max << " events." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	unsigned int i = mu_points - 1;
+	while(i > 0 && acceptance_min[i] > n)
+		i--;
+	return i * delta_mu;
+}
+
+void Feldman_Cousins_Belt::Export(const std::string& filename) const
+{
+	std::ofstream f;
+	f.open(filename);
+	if(!f)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Feldman_Cousins_Belt::Export(): File " << filename << " could not be opened." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	f << std::setprecision(17) << background << "\t" << certainty << "\t" << delta_mu << "\t" << n_max << "\t" << mu_points << std::endl;
+	for(unsigned int i = 0; i < mu_points; i++)
+		f << acceptance_min[i] << "\t" << acceptance_max[i] << std::endl;
+	f.close();
+}
+
+// The belts are identified by the shortest representation of CL and b that reproduces both doubles exactly.
+static std::string Feldman_Cousins_Belt_Key(double certainty, double b)
+{
+	char key[64];
+	for(int precision = 1; precision <= 17; precision++)
+	{
+		std::snprintf(key, sizeof(key), "CL_%.*g_b_%.*g", precision, certainty, precision, b);
+		double certainty_key, b_key;
+		if(std::sscanf(key, "CL_%lg_b_%lg", &certainty_key, &b_key) == 2 && certainty_key == certainty && b_key == b)
+			break;
+	}
+	return std::string(key);
+}
+
+// Only the belts of the tables of [arXiv:physics/9711021], i.e. the standard certainty levels and backgrounds b = 0, 0.5, ..., 15, are cached in the data directory. Other belts, e.g. for the background of every bin, are kept in memory.
+static bool Standard_Feldman_Cousins_Belt(double b, double certainty)
+{
+	bool standard_certainty = (certainty == 0.6827 || certainty == 0.9 || certainty == 0.95 || certainty == 0.99);
+	return standard_certainty && b >= 0.0 && b <= 15.0 && 2.0 * b == std::floor(2.0 * b);
+}
+
+double Feldman_Cousins_Upper_Limit(unsigned long int n, double b, double certainty)
+{
+	// The mutex only protects the look-up. The first thread to miss a belt generates it, and the others wait for its result without blocking the look-ups of other belts.
+	// A belt is generated with a single thread, since the function is usually called from within the worker threads of limit curves.
+	static std::map<std::string, std::shared_future<std::shared_ptr<const Feldman_Cousins_Belt>>> belts;
+	static std::mutex belts_mutex;
+
+	std::string key = Feldman_Cousins_Belt_Key(certainty, b);
+	while(true)
+	{
+		std::shared_future<std::shared_ptr<const Feldman_Cousins_Belt>> belt_future;
+		std::promise<std::shared_ptr<const Feldman_Cousins_Belt>> belt_promise;
+		bool generate = false;
+		{
+			std::lock_guard<std::mutex> lock(belts_mutex);
+			auto entry = belts.find(key);
+			// A belt that is too small for n is replaced, unless another thread is still generating it.
+			if(entry == belts.end() || (entry->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready && entry->second.get()->Maximum_Events() < n))
+			{
+				belts[key] = belt_promise.get_future().share();
+				generate   = true;
+			}
+			belt_future = belts[key];
+		}
+		if(generate)
+		{
+			std::shared_ptr<const Feldman_Cousins_Belt> belt;
+			std::string filename = PROJECT_DIR "data/Feldman_Cousins_Belt_" + key + ".txt";
+			if(libphysica::File_Exists(filename))
+				belt = std::make_shared<const Feldman_Cousins_Belt>(filename);
+			if(belt == nullptr || belt->Maximum_Events() < n)
+			{
+				belt = std::make_shared<const Feldman_Cousins_Belt>(b, certainty, std::max(100ul, 2 * n), 0.005, 1);
+				if(Standard_Feldman_Cousins_Belt(b, certainty))
+					Export_Cached_Table(*belt, filename);
+			}
+			belt_promise.set_value(belt);
+		}
+		std::shared_ptr<const Feldman_Cousins_Belt> belt = belt_future.get();
+		if(belt->Maximum_Events() >= n)
+			return belt->Upper_Limit(n);
+	}
+}
+
+double P_Value_Feldman_Cousins(unsigned long int n, double mu, double b)
+{
+	double lambda							  = mu + b;
+	unsigned long int n_last				  = std::max(1.0 * n, lambda + 10.0 * sqrt(lambda) + 20);
+	std::pair<double, unsigned long int> rank = std::make_pair(Feldman_Cousins_Ratio(n, mu, b), n);
+	double probability_before				  = 0.0;
+	for(unsigned long int k = 0; k <= n_last; k++)
+		if(Feldman_Cousins_Ranked_Before(std::make_pair(Feldman_Cousins_Ratio(k, mu, b), k), rank))
+			probability_before += exp(Log_PMF_Poisson(k, lambda));
+	return std::max(0.0, 1.0 - probability_before);
+}
+
+// 4. Likelihood ratio of a signal strength
+double Log_Likelihood_Signal_Strength(double r, double signals, const std::vector<double>& weights, const std::vector<double>& signal_terms, const std::vector<double>& background_terms)
+{
+	double log_likelihood = -r * signals;
+	for(unsigned int k = 0; k < weights.size(); k++)
+		if(weights[k] > 0.0 && (signal_terms[k] > 0.0 || background_terms[k] > 0.0))
+			log_likelihood += weights[k] * log(r * signal_terms[k] + background_terms[k]);
+	return log_likelihood;
+}
+
+double Best_Fit_Signal_Strength(double signals, const std::vector<double>& weights, const std::vector<double>& signal_terms, const std::vector<double>& background_terms)
+{
+	if(signals <= 0.0)
+		return 0.0;
+	// The log likelihood is concave in r, and its derivative decreases monotonically.
+	bool background_free_terms = false;
+	for(unsigned int k = 0; k < weights.size(); k++)
+		if(weights[k] > 0.0 && signal_terms[k] > 0.0 && background_terms[k] <= 0.0)
+			background_free_terms = true;
+	std::function<double(double)> derivative = [signals, &weights, &signal_terms, &background_terms](double r) {
+		double result = -signals;
+		for(unsigned int k = 0; k < weights.size(); k++)
+			if(weights[k] > 0.0 && signal_terms[k] > 0.0)
+				result += weights[k] * signal_terms[k] / (r * signal_terms[k] + background_terms[k]);
+		return result;
+	};
+	if(!background_free_terms && derivative(0.0) <= 0.0)
+		return 0.0;
+	double r_min = 1.0 / signals;
+	double r_max = r_min;
+	while(derivative(r_min) < 0.0)
+		r_min /= 2.0;
+	while(derivative(r_max) > 0.0)
+		r_max *= 2.0;
+	return (r_min == r_max) ? r_min : libphysica::Find_Root(derivative, r_min, r_max, 1.0e-8 * r_min);
+}
+
+double Golden_Section_Maximum(const std::function<double(double)>& func, double x_min, double x_max, double tolerance)
+{
+	const double golden_ratio = (sqrt(5.0) - 1.0) / 2.0;
+	double x_1				  = x_max - golden_ratio * (x_max - x_min);
+	double x_2				  = x_min + golden_ratio * (x_max - x_min);
+	double f_1				  = func(x_1);
+	double f_2				  = func(x_2);
+	while(x_max - x_min > tolerance)
+	{
+		if(f_1 < f_2)
+		{
+			x_min = x_1;
+			x_1	  = x_2;
+			f_1	  = f_2;
+			x_2	  = x_min + golden_ratio * (x_max - x_min);
+			f_2	  = func(x_2);
+		}
+		else
+		{
+			x_max = x_2;
+			x_2	  = x_1;
+			f_2	  = f_1;
+			x_1	  = x_max - golden_ratio * (x_max - x_min);
+			f_1	  = func(x_1);
+		}
+	}
+	return (f_1 < f_2) ? x_2 : x_1;
+}
+
+double Test_Statistic_Signal_Strength(double r, double signals, const std::vector<double>& weights, const std::vector<double>& signal_terms, const std::vector<double>& background_terms)
+{
+	double best_fit = Best_Fit_Signal_Strength(signals, weights, signal_terms, background_terms);
+	if(signals <= 0.0 || best_fit >= r)
+		return 0.0;
+	double q = 2.0 * (Log_Likelihood_Signal_Strength(best_fit, signals, weights, signal_terms, background_terms) - Log_Likelihood_Signal_Strength(r, signals, weights, signal_terms, background_terms));
+	return std::max(q, 0.0);
+}
+
+// 5. Bayesian upper limit on a signal strength
+// The posterior is integrated on a logarithmic grid of r.
+const unsigned int bayesian_grid_points = 2000;
+
+double Bayesian_Upper_Limit_Signal_Strength(double certainty, double signals, const std::vector<double>& weights, const std::vector<double>& signal_terms, const std::vector<double>& background_terms, double prior_exponent, double r_min)
+{
+	if(signals <= 0.0)
+		return -1.0;
+	else if(prior_exponent <= -1.0 && r_min <= 0.0)
+	{
+		std::cerr << libphysica::Formatted_String("Error", "Red", true) << " in obscura::Bayesian_Upper_Limit_Signal_Strength(): The prior r^" << prior_exponent << " cannot be normalized without a positive lower bound r_min." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	// Without a lower bound, the posterior below 10^-12 expected signals is negligible. The likelihood is negligible beyond n + 100 + 20 sqrt(n) expected signals.
+	double events = std::accumulate(weights.begin(), weights.end(), 0.0);
+	if(r_min <= 0.0)
+		r_min = 1.0e-12 / signals;
+	double r_max = std::max((events + 100.0 + 20.0 * sqrt(events)) / signals, 1000.0 * r_min);
+
+	// Posterior density in ln(r)
+	std::vector<double> log_r = libphysica::Linear_Space(log(r_min), log(r_max), bayesian_grid_points);
+	std::vector<double> log_posterior;
+	for(auto& x : log_r)
+		log_posterior.push_back(Log_Likelihood_Signal_Strength(exp(x), signals, weights, signal_terms, background_terms) + (prior_exponent + 1.0) * x);
+	double log_posterior_max = *std::max_element(log_posterior.begin(), log_posterior.end());
+
+	std::vector<double> cumulative_posterior = {0.0};
+	for(unsigned int i = 1; i < log_r.size(); i++)
+		cumulative_posterior.push_back(cumulative_posterior.back() + 0.5 * (log_r[i] - log_r[i - 1]) * (exp(log_posterior[i] - log_posterior_max) + exp(log_posterior[i - 1] - log_posterior_max)));
+	double target = certainty * cumulative_posterior.back();
+	unsigned int i = std::lower_bound(cumulative_posterior.begin(), cumulative_posterior.end(), target) - cumulative_posterior.begin();
+	if(i == 0)
+		return r_min;
+	double x = log_r[i - 1] + (target - cumulative_posterior[i - 1]) / (cumulative_posterior[i] - cumulative_posterior[i - 1]) * (log_r[i] - log_r[i - 1]);
+	return exp(x);
+}
+
+}	// namespace obscura
@@ -31,16 +31,31 @@ int main(int argc, char* argv[])
 	obscura::Configuration cfg(argv[1]);
 	cfg.Print_Summary();
 
-	std::vector<double> DM_masses = libphysica::Log_Space(cfg.constraints_mass_min, cfg.constraints_mass_max, cfg.constraints_masses);
+	// All certainty levels share the spectra, and the finished masses are appended to a checkpoint, from which an interrupted run with the same configuration resumes.
+	std::vector<std::string> CL_labels = cfg.constraints_certainty_labels;
+	std::string CL_label;
+	for(auto& label : CL_labels)
+		CL_label += "_" + label;
+	if(cfg.constraints_checkpoint)
+		cfg.DM_detector->Use_Checkpoint(cfg.results_path + "DD_Constraints" + CL_label + "_Checkpoint.txt", cfg.configuration_hash);
 
-	std::vector<std::vector<double>> exclusion_limits = cfg.DM_detector->Upper_Limit_Curve(*(cfg.DM), *(cfg.DM_distr), DM_masses, cfg.constraints_certainty);
-	for(unsigned int i = 0; i < exclusion_limits.size(); i++)
-		std::cout << i + 1 << "/" << exclusion_limits.size()
-				  << "\tmDM = " << libphysica::Round(In_Units(exclusion_limits[i][0], (exclusion_limits[i][0] < GeV) ? MeV : GeV)) << ((exclusion_limits[i][0] < GeV) ? " MeV" : " GeV")
-				  << "\tUpper Bound:\t" << libphysica::Round(In_Units(exclusion_limits[i][1], cm * cm)) << std::endl;
-
-	int CL = std::round(100.0 * cfg.constraints_certainty);
-	libphysica::Export_Table(TOP_LEVEL_DIR "results/" + cfg.ID + "/DD_Constraints_" + std::to_string(CL) + ".txt", exclusion_limits, {GeV, cm * cm});
+	std::vector<std::vector<std::vector<double>>> exclusion_limits;
+	if(cfg.constraints_adaptive)
+		exclusion_limits = cfg.DM_detector->Upper_Limit_Curve_Adaptive(*(cfg.DM), *(cfg.DM_distr), cfg.constraints_mass_min, cfg.constraints_mass_max, cfg.constraints_masses, cfg.constraints_certainties, cfg.constraints_tolerance, cfg.constraints_refinements, cfg.constraints_threads);
+	else
+	{
+		std::vector<double> DM_masses = libphysica::Log_Space(cfg.constraints_mass_min, cfg.constraints_mass_max, cfg.constraints_masses);
+		exclusion_limits			  = cfg.DM_detector->Upper_Limit_Curve(*(cfg.DM), *(cfg.DM_distr), DM_masses, cfg.constraints_certainties, cfg.constraints_threads);
+	}
+	for(unsigned int j = 0; j < exclusion_limits.size(); j++)
+	{
+		std::cout << "Certainty level: " << CL_labels[j] << "%" << std::endl;
+		for(unsigned int i = 0; i < exclusion_limits[j].size(); i++)
+			std::cout << i + 1 << "/" << exclusion_limits[j].size()
+					  << "\tmDM = " << libphysica::Round(In_Units(exclusion_limits[j][i][0], (exclusion_limits[j][i][0] < GeV) ? MeV : GeV)) << ((exclusion_limits[j][i][0] < GeV) ? " MeV" : " GeV")
+					  << "\tUpper Bound:\t" << libphysica::Round(In_Units(exclusion_limits[j][i][1], cm * cm)) << std::endl;
+		libphysica::Export_Table(TOP_LEVEL_DIR "results/" + cfg.ID + "/DD_Constraints_" + CL_labels[j] + ".txt", exclusion_limits[j], {GeV, cm * cm});
+	}
 
 	////////////////////////////////////////////////////////////////////////
 	// Final terminal output
@@ -0,0 +1,122 @@
+#include "obscura/Asynchronous_Limits.hpp"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <mutex>
+
+#include "libphysica/Natural_Units.hpp"
+#include "libphysica/Utilities.hpp"
+
+#include "obscura/DM_Halo_Models.hpp"
+#include "obscura/DM_Particle_Standard.hpp"
+#include "obscura/Direct_Detection_Nucleus.hpp"
+#include "obscura/Target_Nucleus.hpp"
+
+using namespace obscura;
+using namespace libphysica::natural_units;
+
+TEST(TestAsynchronousLimits, TestAsynchronousLimitCurve)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Set_Observed_Events(3);
+	auto masses = libphysica::Log_Space(0.1 * GeV, 100.0 * GeV, 10);
+	std::vector<unsigned int> progress;
+	auto callback = [&progress](double mass, double limit, unsigned int completed, unsigned int total) {
+		progress.push_back(completed);
+		EXPECT_EQ(total, 10);
+	};
+	// ACT
+	auto limits = detector.Upper_Limit_Curve(dm, shm, masses);
+	Asynchronous_Limit_Curve computation(detector, dm, shm, masses, 0.95, 1, callback);
+	Asynchronous_Limit_Curve computation_parallel(detector, dm, shm, masses, 0.95, 3);
+	auto limits_async	 = computation.Get();
+	auto limits_parallel = computation_parallel.Get();
+	// ASSERT
+	EXPECT_TRUE(computation.Finished());
+	EXPECT_FALSE(computation.Cancelled());
+	EXPECT_EQ(computation.Completed_Masses(), 10);
+	ASSERT_EQ(progress.size(), 10);
+	for(unsigned int i = 0; i < progress.size(); i++)
+		EXPECT_EQ(progress[i], i + 1);
+	ASSERT_EQ(limits_async.size(), limits.size());
+	ASSERT_EQ(limits_parallel.size(), limits.size());
+	for(unsigned int i = 0; i < limits.size(); i++)
+	{
+		EXPECT_DOUBLE_EQ(limits_async[i][0], limits[i][0]);
+		EXPECT_DOUBLE_EQ(limits_async[i][1], limits[i][1]);
+		EXPECT_DOUBLE_EQ(limits_parallel[i][0], limits[i][0]);
+		EXPECT_DOUBLE_EQ(limits_parallel[i][1], limits[i][1]);
+	}
+	EXPECT_DOUBLE_EQ(dm.mass, 100.0 * GeV);
+}
+
+TEST(TestAsynchronousLimits, TestAsynchronousLimitCurveCertaintyLevels)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Set_Observed_Events(3);
+	auto masses						= libphysica::Log_Space(1.0 * GeV, 100.0 * GeV, 6);
+	std::vector<double> certainties = {0.9, 0.95};
+	// ACT
+	auto limits = detector.Upper_Limit_Curve(dm, shm, masses, certainties, 2);
+	Asynchronous_Limit_Curve computation(detector, dm, shm, masses, certainties, 2);
+	auto limits_async = computation.Get_Limit_Curves();
+	// ASSERT
+	ASSERT_EQ(limits_async.size(), 2);
+	for(unsigned int j = 0; j < certainties.size(); j++)
+	{
+		ASSERT_EQ(limits_async[j].size(), limits[j].size());
+		for(unsigned int i = 0; i < limits[j].size(); i++)
+		{
+			EXPECT_DOUBLE_EQ(limits_async[j][i][0], limits[j][i][0]);
+			EXPECT_DOUBLE_EQ(limits_async[j][i][1], limits[j][i][1]);
+		}
+	}
+}
+
+TEST(TestAsynchronousLimits, TestAsynchronousLimitCurveCancellation)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Set_Observed_Events(3);
+	auto masses = libphysica::Log_Space(10.0 * GeV, 100.0 * GeV, 10);
+	// The callback waits until the handle of the computation is known.
+	Asynchronous_Limit_Curve* computation_pointer = nullptr;
+	std::mutex pointer_mutex;
+	auto callback = [&computation_pointer, &pointer_mutex](double mass, double limit, unsigned int completed, unsigned int total) {
+		std::lock_guard<std::mutex> lock(pointer_mutex);
+		if(completed == 3)
+			computation_pointer->Cancel();
+	};
+	// ACT
+	Asynchronous_Limit_Curve computation(detector, dm, shm, masses, 0.95, 1, nullptr, 1.0e-9);
+	auto limits_budget = computation.Get();
+	pointer_mutex.lock();
+	Asynchronous_Limit_Curve computation_cancelled(detector, dm, shm, masses, 0.95, 1, callback);
+	computation_pointer = &computation_cancelled;
+	pointer_mutex.unlock();
+	auto limits_cancelled = computation_cancelled.Get();
+	// ASSERT
+	EXPECT_TRUE(computation.Time_Budget_Exceeded());
+	EXPECT_TRUE(limits_budget.empty());
+	EXPECT_TRUE(computation_cancelled.Cancelled());
+	EXPECT_FALSE(computation_cancelled.Time_Budget_Exceeded());
+	EXPECT_EQ(computation_cancelled.Completed_Masses(), 3);
+	// The warm start masses, i.e. every 4th mass, are computed first.
+	ASSERT_EQ(limits_cancelled.size(), 3);
+	for(unsigned int i = 0; i < 3; i++)
+		EXPECT_DOUBLE_EQ(limits_cancelled[i][0], masses[4 * i]);
+}
@@ -30,6 +30,10 @@ TEST(TestConfiguration, TestReadConfig1)
 	EXPECT_DOUBLE_EQ(cfg.constraints_mass_max, 100.0);
 	EXPECT_EQ(cfg.constraints_masses, 10);
 	EXPECT_DOUBLE_EQ(cfg.constraints_certainty, 0.95);
+	EXPECT_EQ(cfg.constraints_refinements, 6);
+	ASSERT_EQ(cfg.constraints_certainties.size(), 1);
+	EXPECT_DOUBLE_EQ(cfg.constraints_certainties[0], 0.95);
+	EXPECT_EQ(cfg.constraints_certainty_labels[0], "95");
 }
 
 TEST(TestConfiguration, TestReadConfig2)
@@ -47,4 +51,39 @@ TEST(TestConfiguration, TestReadConfig2)
 	EXPECT_DOUBLE_EQ(cfg.constraints_mass_max, 1.0);
 	EXPECT_EQ(cfg.constraints_masses, 10);
 	EXPECT_DOUBLE_EQ(cfg.constraints_certainty, 0.95);
+	EXPECT_EQ(cfg.constraints_threads, 1);
+	EXPECT_FALSE(cfg.constraints_adaptive);
+	EXPECT_TRUE(cfg.constraints_checkpoint);
+	ASSERT_EQ(cfg.constraints_certainties.size(), 2);
+	EXPECT_DOUBLE_EQ(cfg.constraints_certainties[1], 0.9);
+}
+
+TEST(TestConfiguration, TestReadConfig3)
+{
+	// ARRANGE
+	std::string filename = "test3.cfg";
+	// ACT
+	Configuration cfg(filename);
+	// ASSERT
+	EXPECT_EQ(cfg.ID, "test3");
+	EXPECT_EQ(cfg.DM_detector->name, "Nuclear recoil");
+	EXPECT_EQ(cfg.constraints_threads, 2);
+	EXPECT_TRUE(cfg.constraints_adaptive);
+	EXPECT_DOUBLE_EQ(cfg.constraints_tolerance, 0.05);
+	EXPECT_FALSE(cfg.constraints_checkpoint);
+	ASSERT_EQ(cfg.constraints_certainty_labels.size(), 2);
+	EXPECT_EQ(cfg.constraints_certainty_labels[0], "99.73");
+	EXPECT_EQ(cfg.constraints_certainty_labels[1], "95.4");
+}
+
+TEST(TestConfiguration, TestConfigurationHash)
+{
+	// ARRANGE
+	Configuration cfg_1("test.cfg");
+	Configuration cfg_2("test2.cfg");
+	Configuration cfg_1_again("test.cfg");
+	// ACT & ASSERT
+	EXPECT_EQ(cfg_1.configuration_hash.size(), 16);
+	EXPECT_EQ(cfg_1_again.configuration_hash, cfg_1.configuration_hash);
+	EXPECT_NE(cfg_2.configuration_hash, cfg_1.configuration_hash);
 }
\ No newline at end of file
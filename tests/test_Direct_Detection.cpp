@@ -1,6 +1,14 @@
 #include "obscura/Direct_Detection.hpp"
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <numeric>
+
+#include "libphysica/Integration.hpp"
 #include "libphysica/Natural_Units.hpp"
 #include "libphysica/Utilities.hpp"
 
@@ -62,6 +70,417 @@ TEST(TestDirectDetection, TestPValue)
 	ASSERT_LT(detector.P_Value(dm, shm), 1.0 - CL);
 }
 
+TEST(TestDirectDetection, TestUpperLimitBinnedPoisson)
+{
+	// ARRANGE
+	double CL	= 0.95;
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(10.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Bins(1.0 * keV, 11.0 * keV, 5);
+	detector.Set_Observed_Events(std::vector<unsigned long int>({3, 1, 4, 0, 2}));
+	detector.Set_Expected_Background(std::vector<double>({1.0, 0.5, 0.5, 0.0, 1.0}));
+	// ACT
+	double limit = detector.Upper_Limit(dm, shm, CL);
+	dm.Set_Interaction_Parameter(limit, "Nuclei");
+	// ASSERT
+	EXPECT_NEAR(detector.P_Value(dm, shm), 1.0 - CL, 1e-8);
+	dm.Set_Interaction_Parameter(0.99 * limit, "Nuclei");
+	EXPECT_GT(detector.P_Value(dm, shm), 1.0 - CL);
+}
+
+TEST(TestDirectDetection, TestUpperLimitFeldmanCousins)
+{
+	// ARRANGE
+	double CL	= 0.9;
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Use_Feldman_Cousins();
+	// ACT
+	double limit = detector.Upper_Limit(dm, shm, CL);
+	dm.Set_Interaction_Parameter(limit, "Nuclei");
+	// ASSERT
+	EXPECT_NEAR(detector.DM_Signals_Total(dm, shm), 2.44, 0.01);
+	// The belt's limit lies on a grid of mu, and the P value drops below 1 - CL within one grid step above it.
+	EXPECT_GT(detector.P_Value(dm, shm), 1.0 - CL);
+	dm.Set_Interaction_Parameter(1.01 * limit, "Nuclei");
+	EXPECT_LT(detector.P_Value(dm, shm), 1.0 - CL);
+}
+
+TEST(TestDirectDetection, TestUpperLimitExcludedBackground)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Set_Observed_Events(0);
+	detector.Set_Expected_Background(5.0);
+	// ACT & ASSERT
+	EXPECT_DOUBLE_EQ(detector.Upper_Limit(dm, shm), -1.0);
+}
+
+TEST(TestDirectDetection, TestUpperLimitMaximumGap)
+{
+	// ARRANGE
+	double CL	= 0.9;
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Maximum_Gap({1.0 * keV, 2.5 * keV, 4.0 * keV, 7.0 * keV, 12.0 * keV, 20.0 * keV});
+	// ACT
+	double limit = detector.Upper_Limit(dm, shm, CL);
+	dm.Set_Interaction_Parameter(limit, "Nuclei");
+	// ASSERT
+	ASSERT_GT(limit, 0.0);
+	EXPECT_NEAR(detector.P_Value(dm, shm), 1.0 - CL, 1e-3);
+}
+
+TEST(TestDirectDetection, TestUpperLimitOptimumInterval)
+{
+	// ARRANGE
+	double CL	= 0.9;
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Optimum_Interval({1.0 * keV, 2.5 * keV, 4.0 * keV, 7.0 * keV, 12.0 * keV, 20.0 * keV});
+	// ACT
+	double limit = detector.Upper_Limit(dm, shm, CL);
+	dm.Set_Interaction_Parameter(limit, "Nuclei");
+	// ASSERT
+	ASSERT_GT(limit, 0.0);
+	EXPECT_NEAR(detector.P_Value(dm, shm), 1.0 - CL, 1e-3);
+	dm.Set_Interaction_Parameter(2.0 * limit, "Nuclei");
+	EXPECT_LT(detector.P_Value(dm, shm), 1.0 - CL);
+}
+
+TEST(TestDirectDetection, TestUpperLimitUnbinnedLikelihood)
+{
+	// ARRANGE
+	double CL	= 0.95;
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector_poisson("test", kg * year, {oxygen});
+	detector_poisson.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Unbinned_Likelihood({1.0 * keV, 20.0 * keV});
+	// ACT
+	double limit = detector.Upper_Limit(dm, shm, CL);
+	dm.Set_Interaction_Parameter(limit, "Nuclei");
+	// ASSERT
+	// Without events and background, 2 * (ln L_max - ln L) = 2 * s = 1.645^2.
+	ASSERT_GT(limit, 0.0);
+	EXPECT_NEAR(detector_poisson.DM_Signals_Total(dm, shm), 1.6448536 * 1.6448536 / 2.0, 1.0e-2);
+	EXPECT_NEAR(detector.Log_Likelihood(dm, shm), -1.6448536 * 1.6448536 / 2.0, 1.0e-2);
+	EXPECT_NEAR(detector.P_Value(dm, shm), 1.0 - CL, 1.0e-4);
+}
+
+TEST(TestDirectDetection, TestUnbinnedLikelihood)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(30.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Unbinned_Likelihood({1.0 * keV, 1.5 * keV, 2.0 * keV, 3.3 * keV, 7.0 * keV, 12.0 * keV, 20.0 * keV});
+	detector.Set_Expected_Background(3.0);
+	auto masses	   = libphysica::Log_Space(10 * GeV, 100 * GeV, 3);
+	auto couplings = libphysica::Log_Space(1e-46 * cm * cm, 1e-42 * cm * cm, 5);
+	// ACT
+	auto grid	 = detector.Log_Likelihood_Scan(dm, shm, masses, couplings, 2);
+	double limit = detector.Upper_Limit(dm, shm);
+	// ASSERT
+	int i = 0;
+	for(auto& m : masses)
+		for(auto& c : couplings)
+		{
+			dm.Set_Mass(m);
+			dm.Set_Interaction_Parameter(c, "Nuclei");
+			EXPECT_NEAR(detector.Log_Likelihood(dm, shm), grid[i][2], 1.0e-10 * std::fabs(grid[i][2]));
+			i++;
+		}
+	dm.Set_Mass(30.0 * GeV);
+	dm.Set_Interaction_Parameter(limit, "Nuclei");
+	EXPECT_NEAR(detector.P_Value(dm, shm), 0.05, 1.0e-4);
+	// The likelihood falls off above the limit.
+	double log_likelihood = detector.Log_Likelihood(dm, shm);
+	dm.Set_Interaction_Parameter(2.0 * limit, "Nuclei");
+	EXPECT_LT(detector.Log_Likelihood(dm, shm), log_likelihood);
+}
+
+TEST(TestDirectDetection, TestUpperLimitCLs)
+{
+	// ARRANGE
+	double CL	= 0.95;
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	DM_Detector_Nucleus detector_unbinned("test", kg * year, {oxygen});
+	detector_unbinned.Use_Unbinned_Likelihood({1.0 * keV, 20.0 * keV});
+	// ACT
+	double limit = detector.Upper_Limit(dm, shm, CL);
+	detector.Use_CLs(true, 0.002);
+	detector_unbinned.Use_CLs(true, 0.002);
+	double limit_CLs		  = detector.Upper_Limit(dm, shm, CL);
+	double limit_CLs_unbinned = detector_unbinned.Upper_Limit(dm, shm, CL);
+	// ASSERT
+	// Without events and background, CLs = exp(-s) as for the Poisson CDF.
+	EXPECT_NEAR(limit_CLs, limit, 0.03 * limit);
+	EXPECT_NEAR(limit_CLs_unbinned, limit, 0.03 * limit);
+	dm.Set_Interaction_Parameter(limit_CLs, "Nuclei");
+	EXPECT_NEAR(detector.P_Value(dm, shm), 1.0 - CL, 0.01);
+}
+
+TEST(TestDirectDetection, TestCLsMultithreaded)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(30.0 * GeV, 3.0e-43 * cm * cm);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Bins(2.0 * keV, 10.0 * keV, 4);
+	detector.Set_Observed_Events({4, 3, 1, 0});
+	detector.Set_Expected_Background({3.0, 2.0, 1.0, 0.5});
+	DM_Detector_Nucleus detector_unbinned("test", kg * year, {oxygen});
+	detector_unbinned.Use_Unbinned_Likelihood({1.0 * keV, 1.5 * keV, 4.0 * keV, 12.0 * keV, 20.0 * keV});
+	detector_unbinned.Set_Expected_Background(2.0);
+	// ACT & ASSERT
+	for(DM_Detector* det : std::vector<DM_Detector*> {&detector, &detector_unbinned})
+	{
+		det->Use_CLs(true, 0.01, 20000, 42, 1);
+		double CLs = det->P_Value(dm, shm);
+		det->Use_CLs(true, 0.01, 20000, 42, 3);
+		EXPECT_DOUBLE_EQ(det->P_Value(dm, shm), CLs);
+		EXPECT_GT(CLs, 0.0);
+		EXPECT_LT(CLs, 1.0);
+	}
+}
+
+TEST(TestDirectDetection, TestUpperLimitBayesian)
+{
+	// ARRANGE
+	double CL	= 0.95;
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Set_Observed_Events(3);
+	detector.Use_Bayesian_Limits();
+	DM_Detector_Nucleus detector_log("test", kg * year, {oxygen});
+	detector_log.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector_log.Set_Observed_Events(3);
+	detector_log.Use_Bayesian_Limits(true, "Log", 1.0e-50 * cm * cm);
+	auto masses = libphysica::Log_Space(10.0 * GeV, 100.0 * GeV, 3);
+	// ACT
+	double limit	 = detector.Upper_Limit(dm, shm, CL);
+	double limit_log = detector_log.Upper_Limit(dm, shm, CL);
+	auto curve		 = detector.Upper_Limit_Curve(dm, shm, masses, CL);
+	// ASSERT
+	// With a flat prior of the cross section and without background, the posterior of the signals is a gamma distribution.
+	dm.Set_Interaction_Parameter(limit, "Nuclei");
+	EXPECT_NEAR(detector.DM_Signals_Total(dm, shm), 7.7536, 1.0e-2);
+	EXPECT_LT(limit_log, limit);
+	ASSERT_EQ(curve.size(), 3);
+	EXPECT_DOUBLE_EQ(curve[2][1], limit);
+}
+
+TEST(TestDirectDetection, TestExpectedLimitsPoisson)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Set_Expected_Background(20.0);
+	// ACT
+	std::vector<double> bands		   = detector.Expected_Limits(dm, shm, 0.95, 2000);
+	std::vector<double> bands_parallel = detector.Expected_Limits(dm, shm, 0.95, 2000, 42, 3);
+	double asimov_limit				   = detector.Asimov_Limit(dm, shm);
+	// ASSERT
+	ASSERT_EQ(bands.size(), 5);
+	for(unsigned int i = 0; i < bands.size(); i++)
+		EXPECT_DOUBLE_EQ(bands_parallel[i], bands[i]);
+	for(unsigned int i = 0; i + 1 < bands.size(); i++)
+		EXPECT_LT(bands[i], bands[i + 1]);
+	EXPECT_NEAR(bands[2], asimov_limit, 0.1 * asimov_limit);
+}
+
+TEST(TestDirectDetection, TestExpectedLimitsLikelihoodRatio)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Set_Expected_Background(20.0);
+	std::vector<double> bands_poisson = detector.Expected_Limits(dm, shm, 0.95, 200);
+	detector.Use_Likelihood_Ratio();
+	// ACT
+	std::vector<double> bands		   = detector.Expected_Limits(dm, shm, 0.95, 200);
+	std::vector<double> bands_parallel = detector.Expected_Limits(dm, shm, 0.95, 200, 42, 3);
+	// ASSERT
+	for(unsigned int i = 0; i < bands.size(); i++)
+		EXPECT_DOUBLE_EQ(bands_parallel[i], bands[i]);
+	for(unsigned int i = 0; i + 1 < bands.size(); i++)
+		EXPECT_LE(bands[i], bands[i + 1]);
+	EXPECT_NE(bands[2], bands_poisson[2]);
+}
+
+TEST(TestDirectDetection, TestAsimovLimitStatistics)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Set_Expected_Background(20.0);
+	detector.Set_Observed_Events(20);
+	double asimov_limit_poisson = detector.Asimov_Limit(dm, shm);
+	// ACT & ASSERT
+	// For an integer background, the Asimov data set coincides with the observed events.
+	detector.Use_Likelihood_Ratio();
+	double asimov_limit_likelihood_ratio = detector.Asimov_Limit(dm, shm);
+	EXPECT_DOUBLE_EQ(asimov_limit_likelihood_ratio, detector.Upper_Limit(dm, shm));
+	EXPECT_NE(asimov_limit_likelihood_ratio, asimov_limit_poisson);
+	detector.Use_Likelihood_Ratio(false);
+	detector.Use_Background_Profiling(true, 0.1);
+	double asimov_limit_profiled = detector.Asimov_Limit(dm, shm);
+	EXPECT_NEAR(asimov_limit_profiled, detector.Upper_Limit(dm, shm), 1.0e-3 * asimov_limit_profiled);
+	EXPECT_GT(asimov_limit_profiled, asimov_limit_poisson);
+}
+
+TEST(TestDirectDetection, TestExpectedLimitsBinnedPoisson)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(10.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Bins(1.0 * keV, 11.0 * keV, 5);
+	detector.Set_Expected_Background(std::vector<double>({0.0, 0.0, 0.0, 0.0, 0.0}));
+	// ACT
+	std::vector<double> bands = detector.Expected_Limits(dm, shm, 0.95, 100);
+	// ASSERT
+	for(auto& limit : bands)
+		EXPECT_DOUBLE_EQ(limit, detector.Upper_Limit(dm, shm));
+	EXPECT_DOUBLE_EQ(detector.Asimov_Limit(dm, shm), detector.Upper_Limit(dm, shm));
+}
+
+TEST(TestDirectDetection, TestExpectedLimitsMaximumGap)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector_poisson("test", kg * year, {oxygen});
+	detector_poisson.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Maximum_Gap({1.0 * keV, 20.0 * keV});
+	// ACT
+	std::vector<double> bands_background_free = detector.Expected_Limits(dm, shm, 0.9, 10);
+	detector.Set_Expected_Background(10.0);
+	std::vector<double> bands = detector.Expected_Limits(dm, shm, 0.9, 200, 42, 2);
+	// ASSERT
+	double poisson_limit = detector_poisson.Upper_Limit(dm, shm, 0.9);
+	for(auto& limit : bands_background_free)
+		EXPECT_NEAR(limit, poisson_limit, 1.0e-2 * poisson_limit);
+	for(unsigned int i = 0; i + 1 < bands.size(); i++)
+		EXPECT_LE(bands[i], bands[i + 1]);
+	EXPECT_GT(bands[0], poisson_limit);
+}
+
+TEST(TestDirectDetection, TestExpectedLimitsUnbinnedLikelihood)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Unbinned_Likelihood({1.0 * keV, 20.0 * keV});
+	// ACT
+	double limit_background_free = detector.Upper_Limit(dm, shm);
+	detector.Set_Expected_Background(10.0);
+	std::vector<double> bands		   = detector.Expected_Limits(dm, shm, 0.95, 200, 42, 1);
+	std::vector<double> bands_parallel = detector.Expected_Limits(dm, shm, 0.95, 200, 42, 3);
+	// ASSERT
+	for(unsigned int i = 0; i < bands.size(); i++)
+		EXPECT_DOUBLE_EQ(bands_parallel[i], bands[i]);
+	for(unsigned int i = 0; i + 1 < bands.size(); i++)
+		EXPECT_LE(bands[i], bands[i + 1]);
+	EXPECT_GT(bands[2], limit_background_free);
+}
+
+TEST(TestDirectDetection, TestProjectedLimitCurves)
+{
+	// ARRANGE
+	auto xenon = Get_Nucleus(54);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {xenon});
+	detector.Use_Energy_Bins(2.0 * keV, 10.0 * keV, 4);
+	detector.Set_Expected_Background({2.0, 1.0, 1.0, 0.0});
+	std::vector<double> exposures	= {1.0 * kg * year, 3.0 * kg * year};
+	std::vector<double> backgrounds	= {0.0, 8.0};
+	auto masses						= libphysica::Log_Space(10.0 * GeV, 100.0 * GeV, 4);
+	double asimov_limit_original	= detector.Asimov_Limit(dm, shm);
+	// ACT
+	auto curves			 = detector.Projected_Limit_Curves(dm, shm, masses, exposures, backgrounds);
+	auto curves_parallel = detector.Projected_Limit_Curves(dm, shm, masses, exposures, backgrounds, 0.95, 3);
+	// ASSERT
+	ASSERT_EQ(curves.size(), 4);
+	for(unsigned int c = 0; c < curves.size(); c++)
+	{
+		DM_Detector_Nucleus projection("projection", exposures[c / 2], {xenon});
+		projection.Use_Energy_Bins(2.0 * keV, 10.0 * keV, 4);
+		double b = backgrounds[c % 2];
+		projection.Set_Expected_Background({b / 2.0, b / 4.0, b / 4.0, 0.0});
+		ASSERT_EQ(curves[c].size(), masses.size());
+		ASSERT_EQ(curves_parallel[c].size(), curves[c].size());
+		for(unsigned int i = 0; i < masses.size(); i++)
+		{
+			dm.Set_Mass(masses[i]);
+			double asimov_limit = projection.Asimov_Limit(dm, shm);
+			EXPECT_NEAR(curves[c][i][1], asimov_limit, 1.0e-6 * asimov_limit);
+			EXPECT_DOUBLE_EQ(curves_parallel[c][i][1], curves[c][i][1]);
+		}
+	}
+	// The detector's background is restored.
+	dm.Set_Mass(100.0 * GeV);
+	EXPECT_DOUBLE_EQ(detector.Asimov_Limit(dm, shm), asimov_limit_original);
+}
+
+TEST(TestDirectDetection, TestProjectedLimitCurvesLikelihoodRatio)
+{
+	// ARRANGE
+	auto xenon = Get_Nucleus(54);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {xenon});
+	detector.Use_Energy_Bins(2.0 * keV, 10.0 * keV, 4);
+	detector.Set_Expected_Background({2.0, 1.0, 1.0, 0.0});
+	detector.Use_Likelihood_Ratio();
+	// ACT
+	auto curves = detector.Projected_Limit_Curves(dm, shm, {100.0 * GeV}, {kg * year}, {4.0});
+	// ASSERT
+	ASSERT_EQ(curves.size(), 1);
+	ASSERT_EQ(curves[0].size(), 1);
+	EXPECT_DOUBLE_EQ(curves[0][0][1], detector.Asimov_Limit(dm, shm));
+}
+
 TEST(TestDirectDetection, TestLikelihoods)
 {
 	// ARRANGE
@@ -100,6 +519,101 @@ TEST(TestDirectDetection, TestLogLikelihoodsBinnedPoisson)
 	ASSERT_DOUBLE_EQ(detector.Log_Likelihood(dm, shm), log(detector.Likelihood(dm, shm)));
 }
 
+TEST(TestDirectDetection, TestBackgroundProfiling)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(10.0 * GeV, 1.0e-50 * cm * cm);
+	Standard_Halo_Model shm;
+	std::vector<unsigned long int> events = {15, 18, 9, 30, 2};
+	std::vector<double> backgrounds		  = {10.0, 20.0, 5.0, 25.0, 4.0};
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Bins(1.0 * keV, 11.0 * keV, 5);
+	detector.Set_Observed_Events(events);
+	detector.Set_Expected_Background(backgrounds);
+	double log_likelihood = detector.Log_Likelihood(dm, shm);
+	DM_Detector_Nucleus detector_per_bin(detector), detector_global(detector), detector_constrained(detector);
+	detector_per_bin.Use_Background_Profiling(true, 1.0e4);
+	detector_global.Use_Background_Profiling(true, 1.0e4, false);
+	detector_constrained.Use_Background_Profiling(true, 1.0e-6, false);
+	// ACT & ASSERT
+	// Without a signal and constraint, the background normalizations are n_i / b_i per bin or sum(n_i) / sum(b_i) globally.
+	double log_likelihood_per_bin = 0.0;
+	double log_likelihood_global  = 0.0;
+	for(unsigned int i = 0; i < events.size(); i++)
+	{
+		log_likelihood_per_bin += events[i] * log(events[i]) - events[i] - std::lgamma(events[i] + 1.0);
+		log_likelihood_global += events[i] * log(74.0 / 64.0 * backgrounds[i]) - 74.0 / 64.0 * backgrounds[i] - std::lgamma(events[i] + 1.0);
+	}
+	EXPECT_NEAR(detector_per_bin.Log_Likelihood(dm, shm), log_likelihood_per_bin, 1.0e-6);
+	EXPECT_NEAR(detector_global.Log_Likelihood(dm, shm), log_likelihood_global, 1.0e-6);
+	EXPECT_NEAR(detector_constrained.Log_Likelihood(dm, shm), log_likelihood, 1.0e-6);
+	EXPECT_GT(detector_per_bin.Log_Likelihood(dm, shm), detector_global.Log_Likelihood(dm, shm));
+	EXPECT_GT(detector_global.Log_Likelihood(dm, shm), log_likelihood);
+}
+
+TEST(TestDirectDetection, TestUpperLimitBackgroundProfiling)
+{
+	// ARRANGE
+	double CL	= 0.95;
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(10.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Bins(1.0 * keV, 11.0 * keV, 5);
+	detector.Set_Observed_Events(std::vector<unsigned long int>({3, 1, 4, 0, 2}));
+	detector.Set_Expected_Background(std::vector<double>({1.0, 0.5, 0.5, 0.5, 1.0}));
+	DM_Detector_Nucleus detector_constrained(detector), detector_profiled(detector);
+	detector_constrained.Use_Background_Profiling(true, 1.0e-6);
+	detector_profiled.Use_Background_Profiling(true, 0.5, false);
+	// ACT
+	double limit			 = detector.Upper_Limit(dm, shm, CL);
+	double limit_constrained = detector_constrained.Upper_Limit(dm, shm, CL);
+	double limit_profiled	 = detector_profiled.Upper_Limit(dm, shm, CL);
+	dm.Set_Interaction_Parameter(limit_profiled, "Nuclei");
+	// ASSERT
+	EXPECT_NEAR(limit_constrained, limit, 1.0e-3 * limit);
+	EXPECT_NEAR(detector_profiled.P_Value(dm, shm), 1.0 - CL, 1.0e-3);
+	detector_profiled.Use_Background_Profiling(false, 0.0);
+	EXPECT_DOUBLE_EQ(detector_profiled.Upper_Limit(dm, shm, CL), limit);
+}
+
+TEST(TestDirectDetection, TestUpperLimitLikelihoodRatio)
+{
+	// ARRANGE
+	double CL	= 0.95;
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(10.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Use_Likelihood_Ratio();
+	DM_Detector_Nucleus detector_binned("test", kg * year, {oxygen});
+	detector_binned.Use_Energy_Bins(1.0 * keV, 11.0 * keV, 5);
+	detector_binned.Set_Observed_Events(std::vector<unsigned long int>({3, 1, 4, 0, 2}));
+	detector_binned.Set_Expected_Background(std::vector<double>({1.0, 0.5, 0.5, 0.5, 1.0}));
+	detector_binned.Use_Likelihood_Ratio();
+	DM_Detector_Nucleus detector_profiled(detector_binned);
+	detector_profiled.Use_Background_Profiling(true, 0.5, false);
+	// ACT
+	double limit		  = detector.Upper_Limit(dm, shm, CL);
+	double limit_binned	  = detector_binned.Upper_Limit(dm, shm, CL);
+	double limit_profiled = detector_profiled.Upper_Limit(dm, shm, CL);
+	// ASSERT
+	// Without events and background, q = 2 s, such that the limit corresponds to s = z^2 / 2.
+	dm.Set_Interaction_Parameter(limit, "Nuclei");
+	EXPECT_NEAR(detector.DM_Signals_Total(dm, shm), 1.6448536 * 1.6448536 / 2.0, 1.0e-3);
+	EXPECT_NEAR(detector.P_Value(dm, shm), 1.0 - CL, 1.0e-4);
+	dm.Set_Interaction_Parameter(limit_binned, "Nuclei");
+	EXPECT_NEAR(detector_binned.P_Value(dm, shm), 1.0 - CL, 1.0e-4);
+	dm.Set_Interaction_Parameter(limit_profiled, "Nuclei");
+	EXPECT_NEAR(detector_profiled.P_Value(dm, shm), 1.0 - CL, 1.0e-4);
+	EXPECT_GT(limit_profiled, limit_binned);
+	// The likelihood ratio uses the spectral shape instead of the most constraining bin.
+	detector_binned.Use_Likelihood_Ratio(false);
+	EXPECT_NE(detector_binned.Upper_Limit(dm, shm, CL), limit_binned);
+}
+
 TEST(TestDirectDetection, TestLikelihoodScan)
 {
 	// ARRANGE
@@ -123,12 +637,406 @@ TEST(TestDirectDetection, TestLikelihoodScan)
 			dm.Set_Interaction_Parameter(c, "Nuclei");
 			EXPECT_DOUBLE_EQ(m, grid[i][0]);
 			EXPECT_DOUBLE_EQ(c, grid[i][1]);
-			EXPECT_DOUBLE_EQ(detector.Log_Likelihood(dm, shm), grid[i++][2]);
+			EXPECT_NEAR(detector.Log_Likelihood(dm, shm), grid[i][2], 1.0e-10 * std::fabs(grid[i][2]));
+			i++;
+		}
+}
+
+TEST(TestDirectDetection, TestLikelihoodScanMultithreaded)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Bins(1.0 * keV, 21.0 * keV, 4);
+	detector.Set_Observed_Events(std::vector<unsigned long int>({2, 1, 0, 1}));
+	auto masses	   = libphysica::Log_Space(10, 100, 5);
+	auto couplings = libphysica::Log_Space(1e-40 * cm * cm, 1e-30 * cm * cm, 10);
+	// ACT
+	auto grid_serial   = detector.Log_Likelihood_Scan(dm, shm, masses, couplings);
+	auto grid_parallel = detector.Log_Likelihood_Scan(dm, shm, masses, couplings, 3);
+	// ASSERT
+	ASSERT_EQ(grid_parallel.size(), grid_serial.size());
+	for(unsigned int i = 0; i < grid_serial.size(); i++)
+		for(unsigned int j = 0; j < 3; j++)
+			EXPECT_EQ(grid_parallel[i][j], grid_serial[i][j]);
+}
+
+TEST(TestDirectDetection, TestLikelihoodContours)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Set_Observed_Events(10);
+	detector.Set_Expected_Background(2.0);
+	// ACT
+	auto contours		   = detector.Likelihood_Contours(dm, shm, 10.0 * GeV, 1000.0 * GeV, 1.0e-44 * cm * cm, 1.0e-39 * cm * cm, {0.68, 0.95}, 5, 5, 6);
+	auto contours_parallel = detector.Likelihood_Contours(dm, shm, 10.0 * GeV, 1000.0 * GeV, 1.0e-44 * cm * cm, 1.0e-39 * cm * cm, {0.68, 0.95}, 5, 5, 6, 3);
+	// ASSERT
+	// The likelihood only depends on the signals s, with a maximum at s = 8 for every mass, such that each contour consists of a lower and an upper branch.
+	ASSERT_EQ(contours.size(), 4);
+	ASSERT_EQ(contours_parallel.size(), contours.size());
+	for(unsigned int k = 0; k < contours.size(); k++)
+	{
+		EXPECT_FALSE(contours[k].closed);
+		EXPECT_DOUBLE_EQ(contours[k].delta_chi_square, -2.0 * log(1.0 - contours[k].certainty_level));
+		ASSERT_EQ(contours_parallel[k].points.size(), contours[k].points.size());
+		for(unsigned int i = 0; i < contours[k].points.size(); i++)
+		{
+			EXPECT_DOUBLE_EQ(contours_parallel[k].points[i][1], contours[k].points[i][1]);
+			dm.Set_Mass(contours[k].points[i][0]);
+			dm.Set_Interaction_Parameter(contours[k].points[i][1], "Nuclei");
+			double s				= detector.DM_Signals_Total(dm, shm);
+			double delta_chi_square	= 2.0 * (10.0 * log(10.0 / (s + 2.0)) + s - 8.0);
+			EXPECT_NEAR(delta_chi_square, contours[k].delta_chi_square, 0.05);
+		}
+	}
+}
+
+TEST(TestDirectDetection, TestUpperLimitCurveMultithreaded)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Set_Observed_Events(3);
+	auto masses = libphysica::Log_Space(0.1 * GeV, 100.0 * GeV, 10);
+	// ACT
+	auto limits_serial	 = detector.Upper_Limit_Curve(dm, shm, masses);
+	auto limits_parallel = detector.Upper_Limit_Curve(dm, shm, masses, 0.95, 3);
+	// ASSERT
+	ASSERT_EQ(limits_parallel.size(), limits_serial.size());
+	for(unsigned int i = 0; i < limits_serial.size(); i++)
+	{
+		EXPECT_EQ(limits_parallel[i][0], limits_serial[i][0]);
+		EXPECT_EQ(limits_parallel[i][1], limits_serial[i][1]);
+	}
+	EXPECT_DOUBLE_EQ(dm.mass, 100.0 * GeV);
+}
+
+// A DM particle with a contact interaction, defined outside of obscura without overriding Clone().
+class DM_Particle_Custom : public DM_Particle
+{
+  private:
+	double sigma_p;
+
+  public:
+	explicit DM_Particle_Custom(double mDM)
+	: DM_Particle(mDM), sigma_p(1.0e-40 * cm * cm)
+	{
+		using_cross_section = true;
+	};
+
+	virtual double Get_Interaction_Parameter(std::string target) const override { return sigma_p; };
+	virtual void Set_Interaction_Parameter(double par, std::string target) override { sigma_p = par; };
+	virtual void Set_Sigma_Proton(double sigma) override { sigma_p = sigma; };
+	virtual double Sigma_Proton() const override { return sigma_p; };
+	virtual double dSigma_dq2_Nucleus(double q, const Isotope& target, double vDM, double param = -1.0) const override
+	{
+		return sigma_p * target.A * target.A / 4.0 / pow(libphysica::Reduced_Mass(mass, mProton) * vDM, 2.0);
+	};
+};
+
+TEST(TestDirectDetection, TestUpperLimitCurveWithoutClone)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_Custom dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	auto masses = libphysica::Log_Space(10.0 * GeV, 100.0 * GeV, 5);
+	// ACT
+	auto limits = detector.Upper_Limit_Curve(dm, shm, masses);
+	// ASSERT
+	ASSERT_EQ(limits.size(), masses.size());
+	for(unsigned int i = 0; i < masses.size(); i++)
+		EXPECT_GT(limits[i][1], 0.0);
+	EXPECT_DOUBLE_EQ(dm.mass, 100.0 * GeV);
+}
+
+TEST(TestDirectDetection, TestUpperLimitCurveCheckpoint)
+{
+	// ARRANGE
+	std::string filename = "DD_Constraints_Checkpoint.txt";
+	auto oxygen			 = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Set_Observed_Events(3);
+	auto masses			= libphysica::Log_Space(0.1 * GeV, 100.0 * GeV, 10);
+	auto limits			= detector.Upper_Limit_Curve(dm, shm, masses);
+	auto count_lines	= [&filename]() {
+		   std::ifstream f(filename);
+		   return std::count(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>(), '\n');
+	};
+	// ACT
+	// An interrupted run finishes the first half of the masses, and the restarted run completes the curve.
+	detector.Use_Checkpoint(filename, "config-1");
+	detector.Upper_Limit_Curve(dm, shm, std::vector<double>(masses.begin(), masses.begin() + 5));
+	auto lines_interrupted = count_lines();
+	auto limits_resumed	   = detector.Upper_Limit_Curve(dm, shm, masses, 0.95, 2);
+	auto lines_resumed	   = count_lines();
+	auto limits_repeated   = detector.Upper_Limit_Curve(dm, shm, masses);
+	auto lines_repeated	   = count_lines();
+	// A different configuration starts a new checkpoint.
+	detector.Use_Checkpoint(filename, "config-2");
+	detector.Upper_Limit_Curve(dm, shm, std::vector<double>(masses.begin(), masses.begin() + 3));
+	auto lines_new = count_lines();
+	std::remove(filename.c_str());
+	// ASSERT
+	EXPECT_EQ(lines_interrupted, 1 + 5);
+	EXPECT_EQ(lines_resumed, 1 + 10);
+	EXPECT_EQ(lines_repeated, 1 + 10);
+	EXPECT_EQ(lines_new, 1 + 3);
+	ASSERT_EQ(limits_resumed.size(), limits.size());
+	ASSERT_EQ(limits_repeated.size(), limits.size());
+	for(unsigned int i = 0; i < limits.size(); i++)
+	{
+		EXPECT_DOUBLE_EQ(limits_resumed[i][0], limits[i][0]);
+		EXPECT_NEAR(limits_resumed[i][1], limits[i][1], 1.0e-10 * limits[i][1]);
+		EXPECT_NEAR(limits_repeated[i][1], limits[i][1], 1.0e-10 * limits[i][1]);
+	}
+	EXPECT_DOUBLE_EQ(dm.mass, 100.0 * GeV);
+}
+
+TEST(TestDirectDetection, TestUpperLimitCurveWarmStart)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Maximum_Gap({1.0 * keV, 2.5 * keV, 4.0 * keV, 7.0 * keV, 12.0 * keV, 20.0 * keV});
+	auto masses = libphysica::Log_Space(10.0 * GeV, 100.0 * GeV, 10);
+	// ACT
+	auto limits_serial	 = detector.Upper_Limit_Curve(dm, shm, masses);
+	auto limits_parallel = detector.Upper_Limit_Curve(dm, shm, masses, 0.95, 3);
+	// ASSERT
+	ASSERT_EQ(limits_serial.size(), masses.size());
+	ASSERT_EQ(limits_parallel.size(), masses.size());
+	for(unsigned int i = 0; i < masses.size(); i++)
+	{
+		// The warm starts do not depend on the number of threads.
+		EXPECT_EQ(limits_parallel[i][0], limits_serial[i][0]);
+		EXPECT_EQ(limits_parallel[i][1], limits_serial[i][1]);
+		dm.Set_Mass(masses[i]);
+		double limit = detector.Upper_Limit(dm, shm);
+		EXPECT_NEAR(limits_serial[i][1], limit, 1.0e-3 * limit);
+	}
+}
+
+TEST(TestDirectDetection, TestUpperLimitCurveAdaptive)
+{
+	// ARRANGE
+	double tolerance = 0.02;
+	auto oxygen		 = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	auto masses = libphysica::Log_Space(1.0 * GeV, 1000.0 * GeV, 200);
+	// ACT
+	auto limits_uniform	 = detector.Upper_Limit_Curve(dm, shm, masses);
+	auto limits_adaptive = detector.Upper_Limit_Curve_Adaptive(dm, shm, 1.0 * GeV, 1000.0 * GeV, 10, 0.95, tolerance);
+	auto limits_parallel = detector.Upper_Limit_Curve_Adaptive(dm, shm, 1.0 * GeV, 1000.0 * GeV, 10, 0.95, tolerance, 6, 3);
+	// ASSERT
+	EXPECT_LT(limits_adaptive.size(), limits_uniform.size() / 2);
+	EXPECT_NEAR(limits_adaptive.front()[0], limits_uniform.front()[0], 0.05 * limits_uniform.front()[0]);
+	ASSERT_EQ(limits_parallel.size(), limits_adaptive.size());
+	for(unsigned int i = 0; i < limits_adaptive.size(); i++)
+		EXPECT_DOUBLE_EQ(limits_parallel[i][1], limits_adaptive[i][1]);
+	// Close to the threshold, the curve is too steep to be resolved with 6 refinements.
+	for(auto& entry : limits_uniform)
+		for(unsigned int i = 0; entry[0] > 2.0 * GeV && i + 1 < limits_adaptive.size(); i++)
+			if(limits_adaptive[i][0] <= entry[0] && entry[0] <= limits_adaptive[i + 1][0])
+			{
+				double x				  = log10(entry[0] / limits_adaptive[i][0]) / log10(limits_adaptive[i + 1][0] / limits_adaptive[i][0]);
+				double log10_interpolated = (1.0 - x) * log10(limits_adaptive[i][1]) + x * log10(limits_adaptive[i + 1][1]);
+				EXPECT_NEAR(log10_interpolated, log10(entry[1]), 2.0 * tolerance);
+			}
+}
+
+TEST(TestDirectDetection, TestUpperLimitCertaintyLevels)
+{
+	// ARRANGE
+	std::vector<double> certainties = {0.9, 0.95, 0.9973};
+	auto oxygen						= Get_Nucleus(8);
+	DM_Particle_SI dm(10.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Set_Observed_Events(3);
+	DM_Detector_Nucleus detector_gap("test", kg * year, {oxygen});
+	detector_gap.Use_Maximum_Gap({2.0 * keV, 5.0 * keV, 11.0 * keV});
+	auto masses = libphysica::Log_Space(1.0 * GeV, 100.0 * GeV, 10);
+	// ACT
+	auto limits			   = detector.Upper_Limit(dm, shm, certainties);
+	auto limits_gap		   = detector_gap.Upper_Limit(dm, shm, certainties);
+	auto curves			   = detector.Upper_Limit_Curve(dm, shm, masses, certainties, 2);
+	auto curves_adaptive   = detector.Upper_Limit_Curve_Adaptive(dm, shm, 1.0 * GeV, 100.0 * GeV, 5, {0.9, 0.95});
+	auto curve_adaptive_95 = detector.Upper_Limit_Curve_Adaptive(dm, shm, 1.0 * GeV, 100.0 * GeV, 5, 0.95);
+	// ASSERT
+	ASSERT_EQ(limits.size(), 3);
+	ASSERT_EQ(limits_gap.size(), 3);
+	ASSERT_EQ(curves.size(), 3);
+	for(unsigned int i = 0; i < certainties.size(); i++)
+	{
+		EXPECT_DOUBLE_EQ(limits[i], detector.Upper_Limit(dm, shm, certainties[i]));
+		EXPECT_DOUBLE_EQ(limits_gap[i], detector_gap.Upper_Limit(dm, shm, certainties[i]));
+		if(i > 0)
+		{
+			EXPECT_GT(limits[i], limits[i - 1]);
 		}
+		auto curve = detector.Upper_Limit_Curve(dm, shm, masses, certainties[i]);
+		ASSERT_EQ(curves[i].size(), curve.size());
+		for(unsigned int j = 0; j < curve.size(); j++)
+		{
+			EXPECT_DOUBLE_EQ(curves[i][j][0], curve[j][0]);
+			EXPECT_NEAR(curves[i][j][1], curve[j][1], 1.0e-10 * curve[j][1]);
+		}
+	}
+	// The grid is refined wherever one of the curves requires it.
+	ASSERT_EQ(curves_adaptive.size(), 2);
+	EXPECT_GE(curves_adaptive[1].size(), curve_adaptive_95.size());
+	EXPECT_DOUBLE_EQ(dm.mass, 10.0 * GeV);
 }
+
 // auto masses			= libphysica::Log_Space(10.0 * MeV, 1.0, 5);
 // auto cross_sections = libphysica::Log_Space(1e-47 * cm * cm, 1e-37 * cm * cm, 10);
 // auto llhs			= cfg.DM_detector->Log_Likelihood_Scan(*cfg.DM, *cfg.DM_distr, masses, cross_sections);
 // std::cout << llhs.size() << std::endl;
 // for(auto& entry : llhs)
-// 	std::cout << entry[0] / MeV << "\t" << entry[1] / cm / cm << "\t" << entry[2] << std::endl;
\ No newline at end of file
+// 	std::cout << entry[0] / MeV << "\t" << entry[1] / cm / cm << "\t" << entry[2] << std::endl;
+TEST(TestDirectDetection, TestUpperLimitCurveProgressive)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Set_Observed_Events(3);
+	std::vector<std::vector<std::vector<double>>> curves;
+	std::vector<unsigned int> passes;
+	auto callback = [&curves, &passes](const std::vector<std::vector<double>>& curve, unsigned int pass) {
+		curves.push_back(curve);
+		passes.push_back(pass);
+	};
+	// ACT
+	auto limits_adaptive	= detector.Upper_Limit_Curve_Adaptive(dm, shm, 1.0 * GeV, 1000.0 * GeV, 5);
+	auto limits_progressive = detector.Upper_Limit_Curve_Progressive(dm, shm, 1.0 * GeV, 1000.0 * GeV, callback);
+	auto limits_budget		= detector.Upper_Limit_Curve_Progressive(dm, shm, 1.0 * GeV, 1000.0 * GeV, nullptr, 5, 0.95, 0.02, 6, 1.0e-9);
+	// ASSERT
+	ASSERT_GE(passes.size(), 3);
+	for(unsigned int i = 0; i < passes.size(); i++)
+		EXPECT_EQ(passes[i], i);
+	// The coarse and the full-fidelity pass use the initial grid and agree roughly.
+	ASSERT_EQ(curves[0].size(), curves[1].size());
+	EXPECT_LE(curves[0].size(), 5);
+	for(unsigned int i = 0; i < curves[0].size(); i++)
+	{
+		EXPECT_DOUBLE_EQ(curves[0][i][0], curves[1][i][0]);
+		EXPECT_NEAR(curves[0][i][1], curves[1][i][1], 0.1 * curves[1][i][1]);
+	}
+	// The final curve is the adaptive limit curve, and a tiny time budget stops after the coarse pass.
+	ASSERT_EQ(limits_progressive.size(), limits_adaptive.size());
+	for(unsigned int i = 0; i < limits_adaptive.size(); i++)
+	{
+		EXPECT_DOUBLE_EQ(limits_progressive[i][0], limits_adaptive[i][0]);
+		EXPECT_NEAR(limits_progressive[i][1], limits_adaptive[i][1], 1.0e-3 * limits_adaptive[i][1]);
+	}
+	ASSERT_EQ(limits_budget.size(), curves[0].size());
+	for(unsigned int i = 0; i < limits_budget.size(); i++)
+		EXPECT_DOUBLE_EQ(limits_budget[i][1], curves[0][i][1]);
+	EXPECT_DOUBLE_EQ(dm.mass, 100.0 * GeV);
+}
+
+TEST(TestDirectDetection, TestTabulatedSpectrum)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(5.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector_bins("test", kg * year, {oxygen});
+	detector_bins.Use_Energy_Bins(1.0 * keV, 20.0 * keV, 5);
+	DM_Detector_Nucleus detector_gaps("test", kg * year, {oxygen});
+	detector_gaps.Use_Maximum_Gap({1.0 * keV, 1.5 * keV, 2.5 * keV, 4.0 * keV, 20.0 * keV});
+	std::function<double(double)> dNdE = [&detector_bins, &dm, &shm](double E) {
+		return kg * year * detector_bins.dRdE(E, dm, shm);
+	};
+	double signals = libphysica::Integrate(dNdE, 1.0 * keV, 20.0 * keV);
+	// ACT
+	detector_bins.Set_Fiducial_Values(dm, shm);
+	Tabulated_Spectrum spectrum = detector_bins.DM_Spectrum(dm, shm);
+	auto bins					= detector_bins.DM_Signals_Binned(dm, shm);
+	detector_bins.Reset_Fiducial_Values();
+	Tabulated_Spectrum spectrum_full_range = detector_bins.DM_Spectrum(dm, shm);
+	double signals_gaps					   = detector_gaps.DM_Signals_Total(dm, shm);
+	// ASSERT
+	double endpoint = spectrum.Kinematic_Endpoint();
+	ASSERT_GT(endpoint, 1.0 * keV);
+	ASSERT_LT(endpoint, 20.0 * keV);
+	EXPECT_DOUBLE_EQ(spectrum(1.01 * endpoint), 0.0);
+	EXPECT_DOUBLE_EQ(spectrum(0.5 * keV), 0.0);
+	EXPECT_DOUBLE_EQ(spectrum.Energies().back(), endpoint);
+	EXPECT_NEAR(spectrum.Total_Signals(), signals, 1.0e-3 * signals);
+	EXPECT_NEAR(spectrum.Signals(1.0 * keV, endpoint), spectrum.Total_Signals(), 1.0e-6 * signals);
+	EXPECT_NEAR(spectrum.Inverse_Cumulative_Signals(spectrum.Cumulative_Signals(2.0 * keV)), 2.0 * keV, 1.0e-3 * keV);
+	// The bins and the total of Yellin's methods read from the same tabulated spectrum.
+	EXPECT_NEAR(std::accumulate(bins.begin(), bins.end(), 0.0), spectrum.Total_Signals(), 1.0e-10 * signals);
+	EXPECT_NEAR(signals_gaps, detector_gaps.DM_Spectrum(dm, shm).Total_Signals(), 1.0e-10 * signals);
+	// Without fiducial values, the kinematic endpoint is unknown.
+	EXPECT_DOUBLE_EQ(spectrum_full_range.Kinematic_Endpoint(), 0.0);
+	EXPECT_DOUBLE_EQ(spectrum_full_range.Energies().back(), 20.0 * keV);
+	EXPECT_NEAR(spectrum_full_range.Total_Signals(), signals, 1.0e-3 * signals);
+}
+
+TEST(TestDirectDetection, TestTabulatedSpectrumAdaptiveIntegration)
+{
+	// ARRANGE
+	// The signals from the tabulated spectrum agree with the adaptive integration of the spectrum within 0.1%, or within 10^-6 of the total signals for the nearly empty bins and gaps close to the kinematic endpoint.
+	// This holds for bins, gaps, and totals, and with the kinematic endpoint inside and outside the energy range.
+	double tolerance = 1.0e-3;
+	auto oxygen		 = Get_Nucleus(8);
+	Standard_Halo_Model shm;
+	std::vector<double> energies = {1.0 * keV, 1.3 * keV, 2.2 * keV, 4.0 * keV, 7.5 * keV, 20.0 * keV};
+	DM_Detector_Nucleus detector_threshold("test", kg * year, {oxygen});
+	detector_threshold.Use_Energy_Threshold(1.0 * keV, 20.0 * keV);
+	DM_Detector_Nucleus detector_bins("test", kg * year, {oxygen});
+	detector_bins.Use_Energy_Bins(1.0 * keV, 20.0 * keV, 7);
+	DM_Detector_Nucleus detector_gaps("test", kg * year, {oxygen});
+	detector_gaps.Use_Maximum_Gap(energies);
+	for(double mass : {5.0 * GeV, 100.0 * GeV})
+	{
+		DM_Particle_SI dm(mass);
+		std::function<double(double)> dNdE = [&detector_threshold, &dm, &shm](double E) {
+			return kg * year * detector_threshold.dRdE(E, dm, shm);
+		};
+		// ACT
+		double signals					 = detector_threshold.DM_Signals_Total(dm, shm);
+		std::vector<double> bins		 = detector_bins.DM_Signals_Binned(dm, shm);
+		Tabulated_Spectrum spectrum_gaps = detector_gaps.DM_Spectrum(dm, shm);
+		// ASSERT
+		double signals_adaptive = libphysica::Integrate(dNdE, 1.0 * keV, 20.0 * keV);
+		EXPECT_NEAR(signals, signals_adaptive, tolerance * signals_adaptive);
+		std::vector<double> bin_edges = libphysica::Linear_Space(1.0 * keV, 20.0 * keV, 8);
+		for(unsigned int i = 0; i < bins.size(); i++)
+		{
+			double bin_adaptive = libphysica::Integrate(dNdE, bin_edges[i], bin_edges[i + 1]);
+			EXPECT_NEAR(bins[i], bin_adaptive, tolerance * bin_adaptive + 1.0e-6 * signals_adaptive);
+		}
+		for(unsigned int i = 0; i + 1 < energies.size(); i++)
+		{
+			double gap_adaptive = libphysica::Integrate(dNdE, energies[i], energies[i + 1]);
+			EXPECT_NEAR(spectrum_gaps.Signals(energies[i], energies[i + 1]), gap_adaptive, tolerance * gap_adaptive + 1.0e-6 * signals_adaptive);
+		}
+	}
+}
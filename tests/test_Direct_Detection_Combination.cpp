@@ -0,0 +1,144 @@
+#include "obscura/Direct_Detection_Combination.hpp"
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+#include "libphysica/Natural_Units.hpp"
+#include "libphysica/Statistics.hpp"
+#include "libphysica/Utilities.hpp"
+
+#include "obscura/DM_Halo_Models.hpp"
+#include "obscura/DM_Particle_Standard.hpp"
+#include "obscura/Direct_Detection_Nucleus.hpp"
+#include "obscura/Target_Nucleus.hpp"
+
+using namespace obscura;
+using namespace libphysica::natural_units;
+
+TEST(TestDirectDetectionCombination, TestSingleDetector)
+{
+	// ARRANGE
+	double CL	= 0.95;
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(50.0 * GeV);
+	dm.Set_Interaction_Parameter(1.0e-45 * cm * cm, "Nuclei");
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	DM_Detector_Combination combination("combination", {&detector});
+	// ACT
+	double limit = combination.Upper_Limit(dm, shm, CL);
+	// ASSERT
+	EXPECT_EQ(combination.Number_of_Detectors(), 1);
+	EXPECT_EQ(combination.Target_Particles(), "Nuclei");
+	EXPECT_DOUBLE_EQ(dm.Get_Interaction_Parameter("Nuclei"), 1.0e-45 * cm * cm);
+	// Without events and background, 2 * (ln L_max - ln L) = 2 * s = 1.645^2.
+	dm.Set_Interaction_Parameter(limit, "Nuclei");
+	EXPECT_NEAR(detector.DM_Signals_Total(dm, shm), 1.6448536 * 1.6448536 / 2.0, 1.0e-3);
+	EXPECT_DOUBLE_EQ(combination.Log_Likelihood(dm, shm), detector.Log_Likelihood(dm, shm));
+}
+
+TEST(TestDirectDetectionCombination, TestBestFit)
+{
+	// ARRANGE
+	double CL	= 0.95;
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(50.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Set_Observed_Events(10);
+	detector.Set_Expected_Background(2.0);
+	DM_Detector_Combination combination("combination");
+	combination.Add_Detector(detector);
+	// ACT
+	double limit = combination.Upper_Limit(dm, shm, CL);
+	dm.Set_Interaction_Parameter(limit, "Nuclei");
+	double s = detector.DM_Signals_Total(dm, shm);
+	// ASSERT
+	// The best fit is s = 8.
+	EXPECT_GT(s, 8.0);
+	EXPECT_NEAR(2.0 * (10.0 * log(10.0 / (s + 2.0)) + s - 8.0), 1.6448536 * 1.6448536, 1.0e-3);
+}
+
+TEST(TestDirectDetectionCombination, TestLogLikelihood)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	auto xenon	= Get_Nucleus(54);
+	DM_Particle_SI dm(30.0 * GeV);
+	dm.Set_Interaction_Parameter(1.0e-44 * cm * cm, "Nuclei");
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector_1("test 1", kg * year, {oxygen});
+	detector_1.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector_1.Set_Observed_Events(3);
+	DM_Detector_Nucleus detector_2("test 2", 2.0 * kg * year, {xenon});
+	detector_2.Use_Energy_Bins(2.0 * keV, 10.0 * keV, 4);
+	detector_2.Set_Observed_Events({2, 1, 0, 0});
+	DM_Detector_Combination combination("combination", {&detector_1, &detector_2});
+	// ACT
+	double log_likelihood		   = combination.Log_Likelihood(dm, shm);
+	double log_likelihood_parallel = combination.Log_Likelihood(dm, shm, 2);
+	// ASSERT
+	EXPECT_DOUBLE_EQ(log_likelihood, detector_1.Log_Likelihood(dm, shm) + detector_2.Log_Likelihood(dm, shm));
+	EXPECT_DOUBLE_EQ(log_likelihood_parallel, log_likelihood);
+}
+
+TEST(TestDirectDetectionCombination, TestLogLikelihoodBelowThreshold)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	auto xenon	= Get_Nucleus(54);
+	DM_Particle_SI dm(2.0 * GeV);
+	dm.Set_Interaction_Parameter(1.0e-40 * cm * cm, "Nuclei");
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector_1("test 1", kg * year, {oxygen});
+	detector_1.Use_Energy_Threshold(0.1 * keV, 20 * keV);
+	detector_1.Set_Observed_Events(3);
+	DM_Detector_Nucleus detector_2("test 2", kg * year, {xenon});
+	detector_2.Use_Energy_Threshold(10.0 * keV, 50 * keV);
+	detector_2.Set_Observed_Events(2);
+	detector_2.Set_Expected_Background(1.0);
+	DM_Detector_Combination combination("combination", {&detector_1, &detector_2});
+	// ACT
+	double log_likelihood = combination.Log_Likelihood(dm, shm);
+	// ASSERT
+	// The xenon detector has no signals below its threshold mass, but still contributes its background-only likelihood.
+	ASSERT_LT(dm.mass, detector_2.Minimum_DM_Mass(dm, shm));
+	EXPECT_DOUBLE_EQ(detector_2.DM_Signals_Total(dm, shm), 0.0);
+	EXPECT_DOUBLE_EQ(log_likelihood, detector_1.Log_Likelihood(dm, shm) + libphysica::Log_Likelihood_Poisson(0.0, 2, 1.0));
+}
+
+TEST(TestDirectDetectionCombination, TestUpperLimitCurve)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector_1("test 1", kg * year, {oxygen});
+	detector_1.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	DM_Detector_Nucleus detector_2("test 2", kg * year, {oxygen});
+	detector_2.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	DM_Detector_Nucleus detector_3("test 3", 2.0 * kg * year, {oxygen});
+	detector_3.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	DM_Detector_Combination combination("combination", {&detector_1, &detector_2});
+	DM_Detector_Combination combination_3("combination 3", {&detector_3});
+	auto masses = libphysica::Log_Space(1.0 * GeV, 100.0 * GeV, 5);
+	// ACT
+	auto limits_1		 = detector_1.Upper_Limit_Curve(dm, shm, masses);
+	auto limits_2		 = detector_2.Upper_Limit_Curve(dm, shm, masses);
+	auto limits_3		 = combination_3.Upper_Limit_Curve(dm, shm, masses);
+	auto limits_serial	 = combination.Upper_Limit_Curve(dm, shm, masses);
+	auto limits_parallel = combination.Upper_Limit_Curve(dm, shm, masses, 0.95, 2);
+	// ASSERT
+	ASSERT_EQ(limits_serial.size(), limits_1.size());
+	ASSERT_EQ(limits_parallel.size(), limits_serial.size());
+	for(unsigned int i = 0; i < limits_serial.size(); i++)
+	{
+		EXPECT_DOUBLE_EQ(limits_parallel[i][1], limits_serial[i][1]);
+		EXPECT_LT(limits_serial[i][1], limits_1[i][1]);
+		EXPECT_LT(limits_serial[i][1], limits_2[i][1]);
+		EXPECT_NEAR(limits_serial[i][1], limits_3[i][1], 1.0e-3 * limits_3[i][1]);
+	}
+	EXPECT_DOUBLE_EQ(dm.mass, 100.0 * GeV);
+}
@@ -116,6 +116,22 @@ TEST(TestDirectDetectionCrystal, TestdRdE)
 	ASSERT_EQ(detector.dRdE(Ee, DM, shm), dRdEe_Crystal(Ee, DM, shm, target));
 }
 
+TEST(TestDirectDetectionCrystal, TestdRdEBatch)
+{
+	// ARRANGE
+	DM_Particle_SI DM(500.0 * MeV);
+	DM.Set_Interaction_Parameter(1e-36 * cm * cm, "Electrons");
+	Standard_Halo_Model shm;
+	DM_Detector_Crystal detector("Label", 100 * gram * day, "Si");
+	std::vector<double> energies = {2.0 * eV, 5.0 * eV, 10.0 * eV, 30.0 * eV};
+	// ACT
+	std::vector<double> dRdE = detector.dRdE_Batch(energies, DM, shm);
+	// ASSERT
+	ASSERT_EQ(dRdE.size(), energies.size());
+	for(unsigned int i = 0; i < energies.size(); i++)
+		EXPECT_DOUBLE_EQ(dRdE[i], detector.dRdE(energies[i], DM, shm));
+}
+
 TEST(TestDirectDetectionCrystal, TestDMSignalsTotal)
 {
 	// ARRANGE
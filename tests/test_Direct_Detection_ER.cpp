@@ -75,4 +75,21 @@ TEST(TestDirectDetectionER, TestdRdEIonization)
 	Nucleus nucleus = Get_Nucleus(54);
 	// ACT & ASSERT
 	ASSERT_EQ(detector.dRdE_Ionization(E, DM, shm, nucleus, Xe_5p), dRdEe_Ionization_ER(E, DM, shm, nucleus.Average_Nuclear_Mass(), Xe_5p));
+}
+
+TEST(TestDirectDetectionER, TestdRdEBatch)
+{
+	// ARRANGE
+	DM_Particle_SI DM(100.0 * MeV);
+	DM.Set_Interaction_Parameter(1e-36 * cm * cm, "Electrons");
+	Standard_Halo_Model shm;
+	DM_Detector_Ionization_ER detector("label", kg * day, {"Xe", "Ar"}, {0.5, 0.5});
+	std::vector<double> energies = {1.0 * eV, 10.0 * eV, 25.0 * eV, 100.0 * eV};
+	// ACT
+	std::vector<double> dRdE = detector.dRdE_Batch(energies, DM, shm);
+	// ASSERT
+	ASSERT_EQ(dRdE.size(), energies.size());
+	for(unsigned int i = 0; i < energies.size(); i++)
+		EXPECT_DOUBLE_EQ(dRdE[i], detector.dRdE(energies[i], DM, shm));
+	EXPECT_GT(dRdE[1], dRdE[2]);
 }
\ No newline at end of file
@@ -136,6 +136,30 @@ TEST(TestDirectDetectionNucleus, dRdE)
 	ASSERT_DOUBLE_EQ(detector.dRdE(ER, DM, SHM), dRdER_Nucleus(ER, DM, SHM, Isotope(8, 16)));
 }
 
+TEST(TestDirectDetectionNucleus, dRdEBatch)
+{
+	// ARRANGE
+	DM_Detector_Nucleus detector("Test", kg * day, {Get_Nucleus(8), Get_Nucleus(54)});
+	DM_Detector_Nucleus detector_resolution(detector);
+	detector_resolution.Use_Energy_Threshold(1.0 * keV, 50.0 * keV);
+	detector_resolution.Set_Resolution(1.0 * keV);
+	DM_Particle_SI DM(50.0 * GeV);
+	Standard_Halo_Model SHM;
+	std::vector<double> energies = {0.5 * keV, 2.0 * keV, 10.0 * keV, 40.0 * keV, 500.0 * keV};
+	// ACT
+	std::vector<double> dRdE			= detector.dRdE_Batch(energies, DM, SHM);
+	std::vector<double> dRdE_resolution = detector_resolution.dRdE_Batch(energies, DM, SHM);
+	// ASSERT
+	ASSERT_EQ(dRdE.size(), energies.size());
+	ASSERT_EQ(dRdE_resolution.size(), energies.size());
+	for(unsigned int i = 0; i < energies.size(); i++)
+	{
+		EXPECT_DOUBLE_EQ(dRdE[i], detector.dRdE(energies[i], DM, SHM));
+		EXPECT_DOUBLE_EQ(dRdE_resolution[i], detector_resolution.dRdE(energies[i], DM, SHM));
+	}
+	EXPECT_EQ(dRdE.back(), 0.0);
+}
+
 TEST(TestDirectDetectionNucleus, PrintSummary)
 {
 	// ARRANGE
@@ -0,0 +1,91 @@
+#include "obscura/Global_Fit.hpp"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "libphysica/Natural_Units.hpp"
+
+#include "obscura/DM_Particle_Standard.hpp"
+#include "obscura/Direct_Detection_Nucleus.hpp"
+#include "obscura/Target_Nucleus.hpp"
+
+using namespace obscura;
+using namespace libphysica::natural_units;
+
+TEST(TestGlobalFit, TestEnsembleSamplerCoupling)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Set_Observed_Events(10);
+	detector.Set_Expected_Background(2.0);
+	Ensemble_Sampler sampler({Fit_Parameter("coupling", 1.0e-44 * cm * cm, 1.0e-39 * cm * cm, true)}, dm, shm, {&detector}, 16);
+	// ACT
+	sampler.Run(200);
+	auto chain = sampler.Chain(50);
+	// ASSERT
+	EXPECT_EQ(sampler.Number_of_Steps(), 200);
+	ASSERT_EQ(chain.size(), 150 * 16);
+	// The spectrum is only computed for the initial positions, all moves of the coupling re-scale it.
+	EXPECT_EQ(sampler.Number_of_Spectra(), 16);
+	EXPECT_GT(sampler.Acceptance_Fraction(), 0.2);
+	EXPECT_LT(sampler.Acceptance_Fraction(), 0.9);
+	// The best fit is s = 8, and the posterior of s peaks around it.
+	dm.Set_Interaction_Parameter(sampler.Best_Fit()[0], "Nuclei");
+	EXPECT_NEAR(detector.DM_Signals_Total(dm, shm), 8.0, 0.5);
+	std::vector<double> signals;
+	for(auto& entry : chain)
+	{
+		dm.Set_Interaction_Parameter(entry[2], "Nuclei");
+		signals.push_back(detector.DM_Signals_Total(dm, shm));
+	}
+	std::sort(signals.begin(), signals.end());
+	EXPECT_GT(signals[signals.size() / 2], 5.0);
+	EXPECT_LT(signals[signals.size() / 2], 11.0);
+}
+
+TEST(TestGlobalFit, TestEnsembleSamplerMultithreaded)
+{
+	// ARRANGE
+	std::string filename = "Ensemble_Sampler_Chain.txt";
+	auto oxygen			 = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	detector.Set_Observed_Events(10);
+	detector.Set_Expected_Background(2.0);
+	std::vector<Fit_Parameter> parameters = {Fit_Parameter("mDM", 10.0 * GeV, 1000.0 * GeV, true), Fit_Parameter("coupling", 1.0e-44 * cm * cm, 1.0e-39 * cm * cm, true), Fit_Parameter("v0", 200.0 * km / sec, 260.0 * km / sec)};
+	Ensemble_Sampler sampler(parameters, dm, shm, {&detector}, 8, 42, 2.0, 5);
+	Ensemble_Sampler sampler_parallel(parameters, dm, shm, {&detector}, 8, 42, 2.0, 5);
+	sampler_parallel.Initialize_Walkers({100.0 * GeV, 1.0e-42 * cm * cm, 230.0 * km / sec}, 0.1);
+	sampler.Initialize_Walkers({100.0 * GeV, 1.0e-42 * cm * cm, 230.0 * km / sec}, 0.1);
+	// ACT
+	sampler.Run(3, filename);
+	sampler.Run(2, filename);
+	sampler_parallel.Run(5, "", 3);
+	std::ifstream f(filename);
+	unsigned int lines = std::count(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>(), '\n');
+	f.close();
+	std::remove(filename.c_str());
+	// ASSERT
+	EXPECT_EQ(lines, 1 + 5 * 8);
+	auto chain			= sampler.Chain();
+	auto chain_parallel = sampler_parallel.Chain();
+	ASSERT_EQ(chain.size(), 5 * 8);
+	ASSERT_EQ(chain_parallel.size(), chain.size());
+	for(unsigned int i = 0; i < chain.size(); i++)
+		for(unsigned int j = 0; j < chain[i].size(); j++)
+			EXPECT_DOUBLE_EQ(chain_parallel[i][j], chain[i][j]);
+	// Only the moves of all parameters require new spectra, not the 5 moves of the coupling per step.
+	EXPECT_LE(sampler.Number_of_Spectra(), 8 * (1 + 5));
+	EXPECT_EQ(sampler_parallel.Number_of_Spectra(), sampler.Number_of_Spectra());
+	EXPECT_DOUBLE_EQ(dm.mass, 100.0 * GeV);
+}
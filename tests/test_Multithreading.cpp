@@ -0,0 +1,46 @@
+#include "obscura/Multithreading.hpp"
+#include "gtest/gtest.h"
+
+#include <numeric>
+#include <vector>
+
+using namespace obscura;
+
+TEST(TestMultithreading, TestNumberOfThreads)
+{
+	// ACT & ASSERT
+	EXPECT_EQ(Number_of_Threads(4), 4);
+	EXPECT_GE(Number_of_Threads(0), 1);
+}
+
+TEST(TestMultithreading, TestParallelFor)
+{
+	// ARRANGE
+	unsigned int tasks	 = 100;
+	unsigned int threads = 4;
+	std::vector<unsigned int> results(tasks, 0);
+	std::vector<unsigned int> workers(tasks, threads);
+	// ACT
+	Parallel_For(tasks, threads, [&results, &workers](unsigned int i, unsigned int worker) {
+		results[i] = i * i;
+		workers[i] = worker;
+	});
+	// ASSERT
+	for(unsigned int i = 0; i < tasks; i++)
+	{
+		EXPECT_EQ(results[i], i * i);
+		EXPECT_LT(workers[i], threads);
+	}
+}
+
+TEST(TestMultithreading, TestParallelForSerial)
+{
+	// ARRANGE
+	std::vector<unsigned int> order;
+	// ACT
+	Parallel_For(5, 1, [&order](unsigned int i, unsigned int worker) {
+		order.push_back(i);
+	});
+	// ASSERT
+	ASSERT_EQ(order, std::vector<unsigned int>({0, 1, 2, 3, 4}));
+}
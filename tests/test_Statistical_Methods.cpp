@@ -0,0 +1,230 @@
+#include "obscura/Statistical_Methods.hpp"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "obscura/Multithreading.hpp"
+
+using namespace obscura;
+
+// 1. Maximum gap method a'la Yellin
+TEST(TestStatisticalMethods, TestCDFMaximumGap)
+{
+	// ARRANGE
+	double tolerance = 1.0e-10;
+	// ACT & ASSERT
+	EXPECT_DOUBLE_EQ(CDF_Maximum_Gap(0.0, 5.0), 0.0);
+	EXPECT_DOUBLE_EQ(CDF_Maximum_Gap(5.0, 5.0), 1.0 - exp(-5.0));
+	EXPECT_DOUBLE_EQ(CDF_Maximum_Gap(6.0, 5.0), 1.0);
+	EXPECT_NEAR(CDF_Maximum_Gap(3.0, 10.0), 0.63136620597436, tolerance);
+	EXPECT_NEAR(CDF_Maximum_Gap(1.0, 2.0), 0.264241117657115, tolerance);
+	EXPECT_NEAR(CDF_Maximum_Gap(5.0, 100.0), 0.512113927969008, tolerance);
+	EXPECT_NEAR(CDF_Maximum_Gap(8.0, 1000.0), 0.716047757037521, tolerance);
+	EXPECT_NEAR(CDF_Maximum_Gap(10.0, 5000.0), 0.7971647653839, tolerance);
+}
+
+TEST(TestStatisticalMethods, TestCDFMaximumGapTable)
+{
+	// ARRANGE
+	double tolerance = 1.0e-5;
+	CDF_Maximum_Gap_Table table(0.1, 100.0, 61, -5.0, 20.0, 51, tolerance, 2);
+	// ACT & ASSERT
+	EXPECT_GT(table.Fraction_of_Accurate_Cells(), 0.0);
+	for(double mu : {0.05, 0.5, 3.0, 17.0, 60.0, 200.0})
+		for(double x : {0.1, 0.5, 1.0, 2.0, 4.0, 7.0, 12.0})
+			EXPECT_NEAR(table(x, mu), CDF_Maximum_Gap(x, mu), 2.0 * tolerance);
+	EXPECT_NEAR(CDF_Maximum_Gap_Tabulated(3.0, 10.0), CDF_Maximum_Gap(3.0, 10.0), 2.0e-6);
+}
+
+TEST(TestStatisticalMethods, TestCDFMaximumGapTableExport)
+{
+	// ARRANGE
+	std::string filename = "CDF_Maximum_Gap_Table.txt";
+	CDF_Maximum_Gap_Table table(0.1, 100.0, 31, -5.0, 20.0, 26);
+	// ACT
+	table.Export(filename);
+	CDF_Maximum_Gap_Table imported_table(filename);
+	std::remove(filename.c_str());
+	// ASSERT
+	EXPECT_DOUBLE_EQ(imported_table.Fraction_of_Accurate_Cells(), table.Fraction_of_Accurate_Cells());
+	for(double mu : {0.5, 3.0, 17.0, 60.0})
+		for(double x : {0.1, 0.5, 1.0, 2.0, 4.0, 7.0, 12.0})
+			EXPECT_DOUBLE_EQ(imported_table(x, mu), table(x, mu));
+}
+
+// 2. Optimum interval method a'la Yellin
+TEST(TestStatisticalMethods, TestOptimumIntervalFractions)
+{
+	// ARRANGE
+	std::vector<double> gaps = {1.0, 2.0, 3.0, 4.0};
+	// ACT
+	std::vector<double> fractions = Optimum_Interval_Fractions(gaps, 4);
+	// ASSERT
+	ASSERT_EQ(fractions.size(), 5);
+	EXPECT_DOUBLE_EQ(fractions[0], 0.4);
+	EXPECT_DOUBLE_EQ(fractions[1], 0.7);
+	EXPECT_DOUBLE_EQ(fractions[2], 0.9);
+	EXPECT_DOUBLE_EQ(fractions[3], 1.0);
+	EXPECT_DOUBLE_EQ(fractions[4], 1.0);
+}
+
+TEST(TestStatisticalMethods, TestOptimumIntervalTable)
+{
+	// ARRANGE
+	Optimum_Interval_Table table(1.0, 30.0, 6, 5, 2000, 1, 1);
+	Optimum_Interval_Table table_parallel(1.0, 30.0, 6, 5, 2000, 1, 3);
+	std::vector<double> gaps = {0.1, 0.3, 0.2, 0.4};
+	// ACT & ASSERT
+	double p_value_previous = 1.0;
+	for(double mu : {1.0, 2.0, 5.0, 10.0, 20.0, 30.0})
+	{
+		std::vector<double> fractions = Optimum_Interval_Fractions(gaps, table.Maximum_Events());
+		double p_value				  = table.P_Value(fractions, mu);
+		EXPECT_DOUBLE_EQ(table_parallel.P_Value(fractions, mu), p_value);
+		EXPECT_LE(p_value, p_value_previous);
+		EXPECT_GE(table.C_Max(fractions, mu), 0.0);
+		EXPECT_LE(table.C_Max(fractions, mu), 1.0);
+		p_value_previous = p_value;
+	}
+	EXPECT_LT(p_value_previous, 0.01);
+}
+
+TEST(TestStatisticalMethods, TestOptimumIntervalTableExport)
+{
+	// ARRANGE
+	std::string filename = "Optimum_Interval_Table.txt";
+	Optimum_Interval_Table table(1.0, 30.0, 4, 3, 500);
+	std::vector<double> fractions = Optimum_Interval_Fractions({0.1, 0.3, 0.2, 0.4}, table.Maximum_Events());
+	// ACT
+	table.Export(filename);
+	Optimum_Interval_Table imported_table(filename);
+	std::remove(filename.c_str());
+	// ASSERT
+	EXPECT_EQ(imported_table.Maximum_Events(), table.Maximum_Events());
+	EXPECT_DOUBLE_EQ(imported_table.Minimum_Mu(), table.Minimum_Mu());
+	for(double mu : {1.0, 4.0, 25.0})
+		EXPECT_NEAR(imported_table.P_Value(fractions, mu), table.P_Value(fractions, mu), 1.0e-8);
+}
+
+// 3. Feldman-Cousins confidence belts
+TEST(TestStatisticalMethods, TestFeldmanCousinsBelt)
+{
+	// ARRANGE
+	double tolerance = 0.01;
+	Feldman_Cousins_Belt belt(0.0, 0.9, 10);
+	Feldman_Cousins_Belt belt_background(3.0, 0.9, 10, 0.005, 2);
+	// ACT & ASSERT
+	// Table IV of [arXiv:physics/9711021]
+	std::vector<double> lower_limits = {0.0, 0.11, 0.53, 1.10, 1.47, 1.84};
+	std::vector<double> upper_limits = {2.44, 4.36, 5.91, 7.42, 8.60, 9.99};
+	for(unsigned int n = 0; n < lower_limits.size(); n++)
+	{
+		EXPECT_NEAR(belt.Lower_Limit(n), lower_limits[n], tolerance);
+		EXPECT_NEAR(belt.Upper_Limit(n), upper_limits[n], tolerance);
+	}
+	EXPECT_LT(belt_background.Upper_Limit(0), belt.Upper_Limit(0));
+	EXPECT_DOUBLE_EQ(belt_background.Lower_Limit(0), 0.0);
+	for(unsigned int n = 1; n <= 10; n++)
+		EXPECT_GE(belt_background.Upper_Limit(n), belt_background.Upper_Limit(n - 1));
+}
+
+TEST(TestStatisticalMethods, TestFeldmanCousinsUpperLimit)
+{
+	// ARRANGE
+	double tolerance = 0.01;
+	std::vector<double> upper_limits = {2.44, 4.36, 5.91, 7.42, 8.60, 9.99};
+	std::vector<double> upper_limits_parallel(upper_limits.size());
+	// ACT
+	Parallel_For(upper_limits.size(), 3, [&upper_limits_parallel](unsigned int n, unsigned int worker) {
+		upper_limits_parallel[n] = Feldman_Cousins_Upper_Limit(n, 0.0, 0.9);
+	});
+	// ASSERT
+	for(unsigned int n = 0; n < upper_limits.size(); n++)
+	{
+		EXPECT_NEAR(Feldman_Cousins_Upper_Limit(n, 0.0, 0.9), upper_limits[n], tolerance);
+		EXPECT_DOUBLE_EQ(upper_limits_parallel[n], Feldman_Cousins_Upper_Limit(n, 0.0, 0.9));
+	}
+}
+
+TEST(TestStatisticalMethods, TestPValueFeldmanCousins)
+{
+	// ARRANGE
+	double b		= 3.0;
+	double delta_mu = 0.005;
+	Feldman_Cousins_Belt belt(b, 0.9, 10, delta_mu);
+	// ACT & ASSERT
+	// The belt accepts n for exactly those mu with a P value above 1 - CL.
+	for(unsigned int n = 0; n <= 10; n++)
+	{
+		EXPECT_GT(P_Value_Feldman_Cousins(n, belt.Upper_Limit(n), b), 0.1);
+		EXPECT_LE(P_Value_Feldman_Cousins(n, belt.Upper_Limit(n) + delta_mu, b), 0.1);
+		if(belt.Lower_Limit(n) > 0.0)
+		{
+			EXPECT_GT(P_Value_Feldman_Cousins(n, belt.Lower_Limit(n), b), 0.1);
+			EXPECT_LE(P_Value_Feldman_Cousins(n, belt.Lower_Limit(n) - delta_mu, b), 0.1);
+		}
+	}
+}
+
+TEST(TestStatisticalMethods, TestFeldmanCousinsBeltExport)
+{
+	// ARRANGE
+	std::string filename = "Feldman_Cousins_Belt.txt";
+	Feldman_Cousins_Belt belt(1.5, 0.95, 5, 0.01);
+	// ACT
+	belt.Export(filename);
+	Feldman_Cousins_Belt imported_belt(filename);
+	std::remove(filename.c_str());
+	// ASSERT
+	EXPECT_DOUBLE_EQ(imported_belt.Background(), belt.Background());
+	EXPECT_DOUBLE_EQ(imported_belt.Certainty_Level(), belt.Certainty_Level());
+	EXPECT_EQ(imported_belt.Maximum_Events(), belt.Maximum_Events());
+	for(unsigned int n = 0; n <= 5; n++)
+	{
+		EXPECT_DOUBLE_EQ(imported_belt.Lower_Limit(n), belt.Lower_Limit(n));
+		EXPECT_DOUBLE_EQ(imported_belt.Upper_Limit(n), belt.Upper_Limit(n));
+	}
+}
+
+// 4. Likelihood ratio of a signal strength
+TEST(TestStatisticalMethods, TestSignalStrength)
+{
+	// ARRANGE
+	std::vector<double> weights		 = {3.0, 1.0, 0.0};
+	std::vector<double> signals		 = {2.0, 1.0, 1.0};
+	std::vector<double> background	 = {0.0, 0.0, 0.0};
+	std::vector<double> background_2 = {1.0, 1.0, 1.0};
+	// ACT & ASSERT
+	// Without background, the best fit is the number of events over the total signals.
+	EXPECT_NEAR(Best_Fit_Signal_Strength(4.0, weights, signals, background), 1.0, 1.0e-6);
+	EXPECT_DOUBLE_EQ(Test_Statistic_Signal_Strength(0.5, 4.0, weights, signals, background), 0.0);
+	EXPECT_NEAR(Test_Statistic_Signal_Strength(2.0, 4.0, weights, signals, background), 2.0 * (4.0 * log(0.5) + 4.0), 1.0e-6);
+	// A deficit of events compared to the background gives a vanishing best fit.
+	EXPECT_DOUBLE_EQ(Best_Fit_Signal_Strength(4.0, {0.0, 1.0, 0.0}, signals, background_2), 0.0);
+	double r = Best_Fit_Signal_Strength(4.0, weights, signals, background_2);
+	EXPECT_NEAR(3.0 * 2.0 / (2.0 * r + 1.0) + 1.0 / (r + 1.0), 4.0, 1.0e-6);
+	EXPECT_NEAR(Log_Likelihood_Signal_Strength(r, 4.0, weights, signals, background_2), -4.0 * r + 3.0 * log(2.0 * r + 1.0) + log(r + 1.0), 1.0e-12);
+}
+
+// 5. Bayesian upper limit on a signal strength
+TEST(TestStatisticalMethods, TestBayesianUpperLimit)
+{
+	// ARRANGE
+	double CL		  = 0.95;
+	double tolerance  = 1.0e-3;
+	double limit_log  = Bayesian_Upper_Limit_Signal_Strength(CL, 1.0, {0.0}, {1.0}, {0.0}, -1.0, 0.01);
+	double limit_flat = Bayesian_Upper_Limit_Signal_Strength(CL, 1.0, {0.0}, {1.0}, {0.0});
+	// ACT & ASSERT
+	// Without events, the flat posterior is exp(-s) for any background.
+	EXPECT_NEAR(limit_flat, -log(1.0 - CL), tolerance);
+	EXPECT_NEAR(Bayesian_Upper_Limit_Signal_Strength(CL, 2.0, {0.0}, {2.0}, {3.0}), -log(1.0 - CL) / 2.0, tolerance);
+	// One event with background b = 1: The posterior (s + 1) exp(-s) / 2 gives (s + 2) exp(-s) / 2 = 1 - CL.
+	double s = Bayesian_Upper_Limit_Signal_Strength(CL, 1.0, {1.0}, {1.0}, {1.0});
+	EXPECT_NEAR((s + 2.0) * exp(-s) / 2.0, 1.0 - CL, tolerance);
+	// A log prior favours small signals.
+	EXPECT_LT(limit_log, limit_flat);
+	EXPECT_GT(limit_log, 0.01);
+	EXPECT_DOUBLE_EQ(Bayesian_Upper_Limit_Signal_Strength(CL, 0.0, {0.0}, {0.0}, {0.0}), -1.0);
+}